@@ -0,0 +1,163 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "BatchEvaluator.h"
+
+namespace {
+
+    /// TaskQueue is one worker's double-ended queue of tasks. The owner takes
+    /// tasks from the back, other workers steal from the front.
+    struct TaskQueue {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+}
+
+
+BatchEvaluator::BatchEvaluator(int threads, int split) {
+
+    if (threads <= 0) {
+        threads = (int)std::thread::hardware_concurrency();
+    }
+
+    threadCount = (threads > 0) ? threads : 1;
+    splitSize = (split > 0) ? split : DEFAULT_SPLIT_SIZE;
+}
+
+std::vector<DuelResult> BatchEvaluator::evaluateAll(
+        const std::vector<const DuelingJP *> &duels) const {
+
+    /// DuelWork holds the partial results of one DuelingJP object while its
+    /// tasks are running.
+    struct DuelWork {
+        const DuelingJP *duel = nullptr;
+        std::vector<std::vector<DuelingJP::ValueCount>> upChunks;
+        std::vector<std::vector<DuelingJP::ValueCount>> downChunks;
+        std::atomic<int> chunksLeft{0};
+    };
+
+    std::vector<DuelResult> results(duels.size());
+    std::vector<std::unique_ptr<DuelWork>> work(duels.size());
+    std::vector<TaskQueue> queues(threadCount);
+
+    // tasks queued or running; the pool is done when it reaches 0
+    std::atomic<int> pendingTasks(0);
+
+    auto pushTask = [&](int worker, std::function<void()> task) {
+        pendingTasks.fetch_add(1);
+        std::lock_guard<std::mutex> guard(queues[worker].lock);
+        queues[worker].tasks.push_back(std::move(task));
+    };
+
+    // run by the last chunk of a duel to finish, merges the chunk results
+    auto finishDuel = [&](size_t duelNumber) {
+        DuelWork &duelWork = *work[duelNumber];
+
+        std::vector<DuelingJP::ValueCount> upValues;
+        std::vector<DuelingJP::ValueCount> downValues;
+        for (size_t c = 0; c < duelWork.upChunks.size(); c++) {
+            upValues.insert(upValues.end(), duelWork.upChunks[c].begin(),
+                            duelWork.upChunks[c].end());
+            downValues.insert(downValues.end(), duelWork.downChunks[c].begin(),
+                              duelWork.downChunks[c].end());
+        }
+        DuelingJP::sortValues(upValues);
+        DuelingJP::sortValues(downValues);
+
+        results[duelNumber].upCollisions = DuelingJP::tallyCollisions(upValues);
+        results[duelNumber].downCollisions = DuelingJP::tallyCollisions(downValues);
+        results[duelNumber].inversions =
+                DuelingJP::tallyInversions(upValues, downValues);
+    };
+
+    // split every duel into chunks and deal the chunks out round robin
+    int nextWorker = 0;
+    for (size_t d = 0; d < duels.size(); d++) {
+        work[d] = std::make_unique<DuelWork>();
+        DuelWork &duelWork = *work[d];
+        duelWork.duel = duels[d];
+
+        int distinctSize = duels[d]->getDistinctSize();
+        int chunkCount = (distinctSize + splitSize - 1) / splitSize;
+        if (chunkCount == 0) {
+            chunkCount = 1;
+        }
+
+        duelWork.upChunks.resize(chunkCount);
+        duelWork.downChunks.resize(chunkCount);
+        duelWork.chunksLeft.store(chunkCount);
+
+        for (int c = 0; c < chunkCount; c++) {
+            int begin = c * splitSize;
+            int end = std::min(begin + splitSize, distinctSize);
+
+            pushTask(nextWorker, [&, d, c, begin, end]() {
+                DuelWork &chunkWork = *work[d];
+                chunkWork.duel->peekValues(true, begin, end, chunkWork.upChunks[c]);
+                chunkWork.duel->peekValues(false, begin, end, chunkWork.downChunks[c]);
+                DuelingJP::sortValues(chunkWork.upChunks[c]);
+                DuelingJP::sortValues(chunkWork.downChunks[c]);
+
+                if (chunkWork.chunksLeft.fetch_sub(1) == 1) {
+                    finishDuel(d);
+                }
+            });
+            nextWorker = (nextWorker + 1) % threadCount;
+        }
+    }
+
+    auto runWorker = [&](int worker) {
+        while (pendingTasks.load() > 0) {
+            std::function<void()> task;
+
+            {
+                std::lock_guard<std::mutex> guard(queues[worker].lock);
+                if (!queues[worker].tasks.empty()) {
+                    task = std::move(queues[worker].tasks.back());
+                    queues[worker].tasks.pop_back();
+                }
+            }
+
+            // own queue is empty, so steal the oldest task of another worker
+            for (int i = 1; (!task) && (i < threadCount); i++) {
+                TaskQueue &victim = queues[(worker + i) % threadCount];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                }
+            }
+
+            if (task) {
+                task();
+                pendingTasks.fetch_sub(1);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threadCount; i++) {
+        workers.emplace_back(runWorker, i);
+    }
+    runWorker(0);
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    return results;
+}
+
+int BatchEvaluator::getThreadCount() const {
+    return threadCount;
+}
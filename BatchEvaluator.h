@@ -0,0 +1,107 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#ifndef INC_5011_P2_BATCHEVALUATOR_H
+#define INC_5011_P2_BATCHEVALUATOR_H
+
+#include <stack>
+#include <vector>
+#include "DuelingJP.h"
+
+
+/*
+ * The BatchEvaluator answers the collision and inversion queries for many
+ * DuelingJP objects at once, spreading the work across a pool of threads.
+ * Each thread has its own queue of tasks and, once its queue is empty,
+ * steals tasks from the other threads.
+ *
+ * METHODS:
+ * 1. The constructor accepts the number of threads and the number of
+ * distinct JumpPrime objects per task. A DuelingJP object with more
+ * distinct JumpPrime objects than that is split into several tasks,
+ * whose results are merged by a final task.
+ * 2. evaluate accepts any iterable container of DuelingJP handles (smart
+ * pointers, raw pointers or iterators) and returns one DuelResult per
+ * handle, in the same order as the container. A std::stack, which cannot
+ * be iterated, is evaluated from the bottom to the top.
+ *
+ * ASSUMPTIONS:
+ * 1. The queries are the non-mutating peekCollisions and peekInversions, so
+ * no DuelingJP object is changed. The same object may appear more than
+ * once in the container.
+ * 2. The DuelingJP objects must not be modified while evaluate runs.
+ */
+
+/// DuelResult holds the query results for one DuelingJP object.
+struct DuelResult {
+    /// The result of peekCollisions(true).
+    long long upCollisions = 0;
+    /// The result of peekCollisions(false).
+    long long downCollisions = 0;
+    /// The result of peekInversions().
+    long long inversions = 0;
+};
+
+/// BatchEvaluator runs DuelingJP queries on a work-stealing thread pool.
+class BatchEvaluator {
+
+    static const int DEFAULT_SPLIT_SIZE = 4096;
+
+    /// The number of worker threads.
+    int threadCount;
+
+    /// The largest number of distinct JumpPrime objects handled by one task.
+    int splitSize;
+
+    /// evaluateAll runs the queries for a list of DuelingJP objects.
+    /// @param [in] duels The DuelingJP objects to evaluate.
+    /// @return One DuelResult per DuelingJP object, in the same order.
+    std::vector<DuelResult> evaluateAll(const std::vector<const DuelingJP *> &duels) const;
+
+public:
+
+    /// BatchEvaluator Constructor.
+    /// @param [in] threads The number of worker threads. If 0 or less, the
+    /// number of hardware threads is used.
+    /// @param [in] split The largest number of distinct JumpPrime objects
+    /// handled by one task.
+    BatchEvaluator(int threads = 0, int split = DEFAULT_SPLIT_SIZE);
+
+    /// evaluate runs the queries for every DuelingJP object in a container.
+    /// @param [in] handles A container of pointers to DuelingJP objects.
+    /// @return One DuelResult per handle, in the order of the container.
+    template <typename Container>
+    std::vector<DuelResult> evaluate(const Container &handles) const {
+        std::vector<const DuelingJP *> duels;
+        for (const auto &handle : handles) {
+            duels.push_back(&*handle);
+        }
+
+        return evaluateAll(duels);
+    }
+
+    /// evaluate runs the queries for every DuelingJP object in a stack.
+    /// @param [in] handles A stack of pointers to DuelingJP objects.
+    /// @return One DuelResult per handle, from the bottom of the stack to
+    /// the top.
+    template <typename Handle, typename Sequence>
+    std::vector<DuelResult> evaluate(const std::stack<Handle, Sequence> &handles) const {
+        // the underlying container is protected, but a derived class may
+        // name it through a pointer to member
+        struct StackAccess : std::stack<Handle, Sequence> {
+            static const Sequence &container(const std::stack<Handle, Sequence> &stack) {
+                return stack.*(&StackAccess::c);
+            }
+        };
+
+        return evaluate(StackAccess::container(handles));
+    }
+
+    /// getThreadCount returns the number of worker threads.
+    /// @return The number of worker threads.
+    int getThreadCount() const;
+
+};
+
+
+#endif //INC_5011_P2_BATCHEVALUATOR_H
@@ -0,0 +1,115 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "DuelClient.h"
+
+using DuelProtocol::RequestHeader;
+using DuelProtocol::ResponseHeader;
+
+
+DuelClient::DuelClient(const std::string &path)
+        : clientSocket(-1), nextSequence(1) {
+
+    sockaddr_un address;
+    if (path.size() >= sizeof(address.sun_path)) {
+        return;
+    }
+
+    clientSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (clientSocket < 0) {
+        return;
+    }
+
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+
+    if (connect(clientSocket, (sockaddr *)&address, sizeof(address)) != 0) {
+        close(clientSocket);
+        clientSocket = -1;
+    }
+}
+
+DuelClient::~DuelClient() {
+    if (clientSocket >= 0) {
+        close(clientSocket);
+    }
+}
+
+bool DuelClient::isConnected() const {
+    return (clientSocket >= 0);
+}
+
+bool DuelClient::writeAll(const void *buffer, size_t size) {
+
+    const char *bytes = (const char *)buffer;
+    while (size > 0) {
+        ssize_t written = send(clientSocket, bytes, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes = bytes + written;
+        size = size - written;
+    }
+
+    return true;
+}
+
+unsigned int DuelClient::sendRequest(DuelProtocol::Operation operation,
+                                     const std::string &name, int argument,
+                                     bool testUp, const int *values,
+                                     unsigned int valueCount) {
+
+    if ((clientSocket < 0) || (name.size() > 0xFFFF) ||
+        (valueCount > DuelProtocol::MAX_VALUE_COUNT)) {
+        return 0;
+    }
+
+    RequestHeader header;
+    header.operation = operation;
+    header.flags = testUp ? DuelProtocol::FLAG_UP : 0;
+    header.nameLength = name.size();
+    header.argument = argument;
+    header.valueCount = valueCount;
+    header.sequence = nextSequence;
+
+    if (!writeAll(&header, sizeof(header)) ||
+        !writeAll(name.data(), name.size()) ||
+        !writeAll(values, (size_t)valueCount * sizeof(int))) {
+        return 0;
+    }
+
+    nextSequence++;
+    return header.sequence;
+}
+
+bool DuelClient::readResponse(ResponseHeader &response) {
+
+    if (clientSocket < 0) {
+        return false;
+    }
+
+    char *bytes = (char *)&response;
+    size_t size = sizeof(response);
+    while (size > 0) {
+        ssize_t readSize = read(clientSocket, bytes, size);
+        if (readSize < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readSize <= 0) {
+            return false;
+        }
+        bytes = bytes + readSize;
+        size = size - readSize;
+    }
+
+    return true;
+}
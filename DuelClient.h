@@ -0,0 +1,71 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#ifndef INC_5011_P2_DUELCLIENT_H
+#define INC_5011_P2_DUELCLIENT_H
+
+#include <string>
+#include "DuelProtocol.h"
+
+
+/*
+ * The DuelClient connects to a DuelServer over a Unix domain socket and
+ * sends it requests. Requests may be pipelined: any number of requests can
+ * be sent before their responses are read, and responses arrive in the
+ * order the requests were sent.
+ */
+
+/// DuelClient sends DuelProtocol requests to a DuelServer.
+class DuelClient {
+
+    /// The connected socket, or -1 if not connected.
+    int clientSocket;
+
+    /// The sequence number of the next request.
+    unsigned int nextSequence;
+
+    /// writeAll writes a buffer to the socket.
+    /// @param [in] buffer The bytes to write.
+    /// @param [in] size The number of bytes to write.
+    /// @return true if every byte was written.
+    bool writeAll(const void *buffer, size_t size);
+
+public:
+
+    /// DuelClient Constructor connects to a DuelServer.
+    /// @param [in] path The path of the server's socket.
+    explicit DuelClient(const std::string &path);
+
+    /// DuelClient Destructor closes the connection.
+    ~DuelClient();
+
+    DuelClient(const DuelClient &) = delete;
+    DuelClient &operator=(const DuelClient &) = delete;
+
+    /// isConnected returns whether the client is connected.
+    /// @return true if connected.
+    bool isConnected() const;
+
+    /// sendRequest sends a request without waiting for its response.
+    /// @param [in] operation The operation to request.
+    /// @param [in] name The name of the duel.
+    /// @param [in] argument The number of passes, for Step.
+    /// @param [in] testUp The direction, for Step and CountCollisions.
+    /// @param [in] values The initial values, for Create.
+    /// @param [in] valueCount The number of initial values.
+    /// @return The sequence number of the request, or 0 if it could not be
+    /// sent.
+    unsigned int sendRequest(DuelProtocol::Operation operation,
+                             const std::string &name, int argument = 0,
+                             bool testUp = true, const int *values = nullptr,
+                             unsigned int valueCount = 0);
+
+    /// readResponse waits for the response to the oldest unanswered request.
+    /// @param [out] response The response read.
+    /// @return true if a response was read.
+    bool readResponse(DuelProtocol::ResponseHeader &response);
+
+};
+
+
+#endif //INC_5011_P2_DUELCLIENT_H
@@ -0,0 +1,77 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#ifndef INC_5011_P2_DUELPROTOCOL_H
+#define INC_5011_P2_DUELPROTOCOL_H
+
+
+/*
+ * The binary protocol spoken between a DuelServer and its clients over a
+ * Unix domain socket.
+ *
+ * Every request is a RequestHeader, followed by nameLength bytes of duel
+ * name, followed by valueCount 32-bit initial values. Every request is
+ * answered by exactly one ResponseHeader, in the order the requests were
+ * sent, so a client may send many requests before reading any response.
+ *
+ * OPERATIONS:
+ * 1. Create builds a DuelingJP object from the values and stores it under
+ * the name, replacing any object already stored under it.
+ * 2. Destroy removes the named object.
+ * 3. Step runs argument passes of countCollisions in the direction given by
+ * the FLAG_UP bit, advancing every JumpPrime object without reporting. At
+ * most MAX_STEP_PASSES passes are run per request; larger requests are
+ * answered with BadRequest.
+ * 4. CountCollisions and CountInversions run the DuelingJP queries of the
+ * same name and return their result.
+ *
+ * ASSUMPTIONS:
+ * 1. Both ends use the byte order of the machine they run on, which is the
+ * same machine for a Unix domain socket.
+ * 2. Every request is answered on the thread that polls all connections, so
+ * the limits below bound how long one request can keep the others waiting.
+ */
+
+namespace DuelProtocol {
+
+    /// The operations a client may request.
+    enum Operation : unsigned char {
+        Create = 1, Destroy, Step, CountCollisions, CountInversions
+    };
+
+    /// The status returned with every response.
+    enum Status : int {
+        Ok = 0, UnknownDuel = 1, BadRequest = 2
+    };
+
+    /// Set in RequestHeader::flags to query in the up() direction.
+    const unsigned char FLAG_UP = 1;
+
+    /// The largest number of initial values accepted in one request.
+    const unsigned int MAX_VALUE_COUNT = 1u << 16;
+
+    /// The largest number of passes a single Step request may run.
+    const int MAX_STEP_PASSES = 1024;
+
+    /// RequestHeader starts every request.
+    struct RequestHeader {
+        unsigned char operation;
+        unsigned char flags;
+        unsigned short nameLength;
+        int argument;
+        unsigned int valueCount;
+        unsigned int sequence;
+    };
+
+    /// ResponseHeader is the whole of every response. The result is wide
+    /// enough for any inversion count.
+    struct ResponseHeader {
+        unsigned int sequence;
+        int status;
+        long long result;
+    };
+
+}
+
+
+#endif //INC_5011_P2_DUELPROTOCOL_H
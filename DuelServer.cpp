@@ -0,0 +1,249 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "DuelServer.h"
+
+using DuelProtocol::RequestHeader;
+using DuelProtocol::ResponseHeader;
+
+namespace {
+
+    /// How long a poll waits before checking whether the server was stopped.
+    const int POLL_TIMEOUT_MS = 100;
+
+    /// How much is read from a connection at once.
+    const size_t READ_SIZE = 65536;
+
+    /// The largest number of pending connections.
+    const int LISTEN_BACKLOG = 64;
+
+}
+
+
+DuelServer::DuelServer(const std::string &path)
+        : socketPath(path), running(false) {
+}
+
+bool DuelServer::serve() {
+
+    sockaddr_un address;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+
+    // only a stale socket may be replaced, never a file that happens to
+    // share the path
+    struct stat pathStatus;
+    if (lstat(socketPath.c_str(), &pathStatus) == 0) {
+        if (!S_ISSOCK(pathStatus.st_mode)) {
+            return false;
+        }
+        unlink(socketPath.c_str());
+    } else if (errno != ENOENT) {
+        return false;
+    }
+
+    int listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenSocket < 0) {
+        return false;
+    }
+
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    if ((bind(listenSocket, (sockaddr *)&address, sizeof(address)) != 0) ||
+        (listen(listenSocket, LISTEN_BACKLOG) != 0)) {
+        close(listenSocket);
+        return false;
+    }
+
+    running.store(true);
+    std::vector<Connection> connections;
+
+    while (running.load()) {
+
+        // the listening socket first, then one entry per connection
+        std::vector<pollfd> pollList(connections.size() + 1);
+        pollList[0].fd = listenSocket;
+        pollList[0].events = POLLIN;
+        for (size_t i = 0; i < connections.size(); i++) {
+            pollList[i + 1].fd = connections[i].socket;
+            pollList[i + 1].events = POLLIN;
+            if (!connections[i].output.empty()) {
+                pollList[i + 1].events |= POLLOUT;
+            }
+        }
+
+        if (poll(pollList.data(), pollList.size(), POLL_TIMEOUT_MS) <= 0) {
+            continue;
+        }
+
+        // answer before accepting, since accepting changes the list
+        std::vector<bool> closed(connections.size(), false);
+        for (size_t i = 0; i < connections.size(); i++) {
+            Connection &connection = connections[i];
+            short events = pollList[i + 1].revents;
+
+            if (events & POLLIN) {
+                char buffer[READ_SIZE];
+                ssize_t readSize = read(connection.socket, buffer, sizeof(buffer));
+                if (readSize == 0) {
+                    closed[i] = true;
+                } else if (readSize < 0) {
+                    closed[i] = (errno != EAGAIN) && (errno != EWOULDBLOCK) &&
+                                (errno != EINTR);
+                } else {
+                    connection.input.insert(connection.input.end(),
+                                            buffer, buffer + readSize);
+                    closed[i] = !handleInput(connection);
+                }
+            } else if (events & (POLLHUP | POLLERR)) {
+                closed[i] = true;
+            }
+
+            if ((!closed[i]) && (!connection.output.empty())) {
+                // a client that went away must not raise SIGPIPE
+                ssize_t written = send(connection.socket, connection.output.data(),
+                                       connection.output.size(), MSG_NOSIGNAL);
+                if (written > 0) {
+                    connection.output.erase(connection.output.begin(),
+                                            connection.output.begin() + written);
+                } else if ((written < 0) && (errno != EAGAIN) &&
+                           (errno != EWOULDBLOCK) && (errno != EINTR)) {
+                    closed[i] = true;
+                }
+            }
+        }
+
+        for (size_t i = connections.size(); i > 0; i--) {
+            if (closed[i - 1]) {
+                close(connections[i - 1].socket);
+                connections.erase(connections.begin() + (i - 1));
+            }
+        }
+
+        if (pollList[0].revents & POLLIN) {
+            int clientSocket = accept(listenSocket, nullptr, nullptr);
+            if (clientSocket >= 0) {
+                // a slow client must not block the others
+                fcntl(clientSocket, F_SETFL, fcntl(clientSocket, F_GETFL) | O_NONBLOCK);
+                connections.push_back(Connection{clientSocket, {}, {}});
+            }
+        }
+    }
+
+    for (Connection &connection : connections) {
+        close(connection.socket);
+    }
+    close(listenSocket);
+    unlink(socketPath.c_str());
+
+    return true;
+}
+
+void DuelServer::stop() {
+    running.store(false);
+}
+
+bool DuelServer::handleInput(Connection &connection) {
+
+    size_t position = 0;
+
+    // answer every complete request that has arrived
+    while (connection.input.size() - position >= sizeof(RequestHeader)) {
+        RequestHeader header;
+        std::memcpy(&header, connection.input.data() + position, sizeof(header));
+
+        if (header.valueCount > DuelProtocol::MAX_VALUE_COUNT) {
+            return false;
+        }
+
+        size_t requestSize = sizeof(RequestHeader) + header.nameLength +
+                             (size_t)header.valueCount * sizeof(int);
+        if (connection.input.size() - position < requestSize) {
+            break;
+        }
+
+        const char *body = connection.input.data() + position + sizeof(RequestHeader);
+        std::string name(body, header.nameLength);
+
+        // memcpy may not be given the null data() of an empty vector
+        std::vector<int> values(header.valueCount);
+        if (header.valueCount > 0) {
+            std::memcpy(values.data(), body + header.nameLength,
+                        values.size() * sizeof(int));
+        }
+
+        ResponseHeader response = runRequest(header, name, values.data());
+        const char *responseBytes = (const char *)&response;
+        connection.output.insert(connection.output.end(), responseBytes,
+                                 responseBytes + sizeof(response));
+
+        position = position + requestSize;
+    }
+
+    connection.input.erase(connection.input.begin(),
+                           connection.input.begin() + position);
+
+    return true;
+}
+
+ResponseHeader DuelServer::runRequest(const RequestHeader &header,
+                                      const std::string &name,
+                                      const int *values) {
+
+    ResponseHeader response;
+    response.sequence = header.sequence;
+    response.status = DuelProtocol::Ok;
+    response.result = 0;
+
+    bool testUp = (header.flags & DuelProtocol::FLAG_UP) != 0;
+
+    if (header.operation == DuelProtocol::Create) {
+        duels[name] = std::make_unique<DuelingJP>(values, (int)header.valueCount);
+        response.result = duels[name]->getSize();
+        return response;
+    }
+
+    auto duel = duels.find(name);
+    if (duel == duels.end()) {
+        response.status = DuelProtocol::UnknownDuel;
+        return response;
+    }
+
+    switch (header.operation) {
+        case DuelProtocol::Destroy:
+            duels.erase(duel);
+            break;
+        case DuelProtocol::Step:
+            if (header.argument > DuelProtocol::MAX_STEP_PASSES) {
+                response.status = DuelProtocol::BadRequest;
+                break;
+            }
+            for (int i = 0; i < header.argument; i++) {
+                duel->second->countCollisions(testUp);
+            }
+            response.result = (header.argument > 0) ? header.argument : 0;
+            break;
+        case DuelProtocol::CountCollisions:
+            response.result = duel->second->countCollisions(testUp);
+            break;
+        case DuelProtocol::CountInversions:
+            response.result = duel->second->countInversions();
+            break;
+        default:
+            response.status = DuelProtocol::BadRequest;
+            break;
+    }
+
+    return response;
+}
@@ -0,0 +1,87 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#ifndef INC_5011_P2_DUELSERVER_H
+#define INC_5011_P2_DUELSERVER_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "DuelingJP.h"
+#include "DuelProtocol.h"
+
+
+/*
+ * The DuelServer keeps named DuelingJP objects in memory and answers
+ * requests for them from many client processes over a Unix domain socket,
+ * so the clients do not rebuild the objects or their nearest primes.
+ *
+ * METHODS:
+ * 1. The constructor accepts the path of the socket to listen on.
+ * 2. serve listens and answers requests until stop is called. It runs on a
+ * single thread, polling all connections; requests from one connection are
+ * answered in order, and as many as have arrived are answered per poll.
+ * 3. stop may be called from another thread or a signal handler.
+ *
+ * ASSUMPTIONS:
+ * 1. A malformed request closes its connection, as does a Create request
+ * with more than MAX_VALUE_COUNT values. A Step request over
+ * MAX_STEP_PASSES is answered with BadRequest.
+ * 2. A socket left at the socket path by an earlier server is removed when
+ * serving starts. Any other file there makes serve fail rather than be
+ * deleted.
+ */
+
+/// DuelServer serves DuelingJP queries over a Unix domain socket.
+class DuelServer {
+
+    /// Connection holds the buffered input and output of one client.
+    struct Connection {
+        int socket;
+        std::vector<char> input;
+        std::vector<char> output;
+    };
+
+    /// The path of the listening socket.
+    std::string socketPath;
+
+    /// The DuelingJP objects, by name.
+    std::unordered_map<std::string, std::unique_ptr<DuelingJP>> duels;
+
+    /// Cleared to make serve return.
+    std::atomic<bool> running;
+
+    /// handleInput answers every complete request in a connection's input.
+    /// @param [in,out] connection The connection to read from and reply to.
+    /// @return false if a request was malformed.
+    bool handleInput(Connection &connection);
+
+    /// runRequest performs a single request.
+    /// @param [in] header The request header.
+    /// @param [in] name The name of the duel.
+    /// @param [in] values The initial values sent with the request.
+    /// @return The response to send.
+    DuelProtocol::ResponseHeader runRequest(const DuelProtocol::RequestHeader &header,
+                                            const std::string &name,
+                                            const int *values);
+
+public:
+
+    /// DuelServer Constructor.
+    /// @param [in] path The path of the Unix domain socket to listen on.
+    explicit DuelServer(const std::string &path);
+
+    /// serve listens on the socket and answers requests until stopped.
+    /// @return true if the server stopped normally, false if the socket
+    /// could not be set up.
+    bool serve();
+
+    /// stop makes serve return within a short time.
+    void stop();
+
+};
+
+
+#endif //INC_5011_P2_DUELSERVER_H
@@ -3,7 +3,52 @@
 // Revision: 1.0
 
 #include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
 #include "DuelingJP.h"
+#include "OpTrace.h"
+
+namespace {
+
+    /// The number of items a thread claims at once in runParallel.
+    const int PARALLEL_GRAIN = 16;
+
+    /// runParallel calls work(begin, end) over consecutive ranges covering
+    /// itemCount items. Threads claim ranges as they finish, since prime
+    /// searches take very different times.
+    /// @param [in] itemCount The number of items.
+    /// @param [in] threads The number of threads, or 0 for one per hardware
+    /// thread. The calling thread is one of them.
+    /// @param [in] work The function run on each range.
+    template <typename Function>
+    void runParallel(int itemCount, int threads, Function work) {
+
+        if (threads <= 0) {
+            threads = (int)std::thread::hardware_concurrency();
+        }
+        int rangeCount = (itemCount + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN;
+        threads = std::max(1, std::min(threads, rangeCount));
+
+        std::atomic<int> nextItem(0);
+        auto runRanges = [&]() {
+            int begin;
+            while ((begin = nextItem.fetch_add(PARALLEL_GRAIN)) < itemCount) {
+                work(begin, std::min(begin + PARALLEL_GRAIN, itemCount));
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (int i = 1; i < threads; i++) {
+            workers.emplace_back(runRanges);
+        }
+        runRanges();
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+    }
+
+}
 
 
 bool DuelingJP::areActive() {
@@ -22,6 +67,7 @@ bool DuelingJP::areActive() {
 
 void DuelingJP::reactivateJumpers() {
     // note: the JumpPrime objects should never need to be reset
+    invalidateSorted();
 
     for (int i = 0; i < listSize; i++) {
         // if JumpPrime i is inactive
@@ -40,22 +86,365 @@ bool DuelingJP::testJumper(int jumperNumber) {
     return true;
 }
 
+void DuelingJP::peekValues(bool testUp, int begin, int end,
+                           std::vector<ValueCount> &values) const {
 
-// assumption: all values in initValues are valid
-DuelingJP::DuelingJP(const int *initValues, int size) {
+    for (int i = begin; i < end; i++) {
+        ValueCount entry;
+        entry.value = testUp ? jumperList[i].peekUp() : jumperList[i].peekDown();
+        entry.count = multiplicity[i];
+        values.push_back(entry);
+    }
+}
+
+void DuelingJP::queryValues(bool testUp, std::vector<ValueCount> &values) {
 
-    listSize = size;
-    jumperList = new JumpPrime[listSize];
+    invalidateSorted();
 
+    // every member of a group returns the same value, so each distinct
+    // JumpPrime is only queried once
     for (int i = 0; i < listSize; i++) {
-        JumpPrime tempJP(initValues[i]);
-        jumperList[i] = tempJP;
+        testJumper(i);
+        ValueCount entry;
+        entry.value = testUp ?
+                jumperList[i].up(deferJumps) :
+                jumperList[i].down(deferJumps);
+        entry.count = multiplicity[i];
+        values.push_back(entry);
+        updatePending(i);
+    }
+}
+
+void DuelingJP::queryInversionValues(std::vector<ValueCount> &upValues,
+                                     std::vector<ValueCount> &downValues) {
+
+    invalidateSorted();
+
+    for (int i = 0; i < listSize; i++) {
+        ValueCount entry;
+        entry.count = multiplicity[i];
+
+        // In case the JumpPrime was inactive
+        testJumper(i);
+        entry.value = jumperList[i].up(deferJumps);
+        upValues.push_back(entry);
+
+        // In case the up jump deactivated it. If the up() deferred a jump,
+        // down() only finds the new lower prime, so the upper prime search
+        // stays queued.
+        testJumper(i);
+        entry.value = jumperList[i].down(deferJumps);
+        downValues.push_back(entry);
+        updatePending(i);
+    }
+}
+
+void DuelingJP::sortValues(std::vector<ValueCount> &values) {
+
+    std::sort(values.begin(), values.end(),
+              [](const ValueCount &a, const ValueCount &b) {
+                  return a.value < b.value;
+              });
+
+    // merge runs of the same value into their first entry
+    size_t mergedSize = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        if ((mergedSize > 0) && (values[mergedSize - 1].value == values[i].value)) {
+            values[mergedSize - 1].count += values[i].count;
+        } else {
+            values[mergedSize] = values[i];
+            mergedSize++;
+        }
+    }
+
+    values.resize(mergedSize);
+}
+
+long long DuelingJP::tallyCollisions(const std::vector<ValueCount> &values) {
+
+    // every JumpPrime after the first to return a value is a collision
+    long long returnCount = 0;
+    for (const ValueCount &entry : values) {
+        returnCount = returnCount + entry.count - 1;
+    }
+
+    return returnCount;
+}
+
+long long DuelingJP::tallyInversions(const std::vector<ValueCount> &upValues,
+                                     const std::vector<ValueCount> &downValues) {
+
+    // merged counts from large populations overflow an int when multiplied
+    long long inversionCounter = 0;
+
+    // both lists are sorted, so walk them together
+    size_t upTrack = 0;
+    size_t downTrack = 0;
+    while ((upTrack < upValues.size()) && (downTrack < downValues.size())) {
+        if (upValues[upTrack].value < downValues[downTrack].value) {
+            upTrack++;
+        } else if (downValues[downTrack].value < upValues[upTrack].value) {
+            downTrack++;
+        } else {
+            inversionCounter = inversionCounter +
+                    (long long)upValues[upTrack].count * downValues[downTrack].count;
+            upTrack++;
+            downTrack++;
+        }
+    }
+
+    return inversionCounter;
+}
+
+long long DuelingJP::tallyShared(const std::vector<ValueCount> &values,
+                                 const std::vector<ValueCount> &otherValues) {
+
+    long long sharedCounter = 0;
+
+    size_t track = 0;
+    size_t otherTrack = 0;
+    while ((track < values.size()) && (otherTrack < otherValues.size())) {
+        if (values[track].value < otherValues[otherTrack].value) {
+            track++;
+        } else if (otherValues[otherTrack].value < values[track].value) {
+            otherTrack++;
+        } else {
+            sharedCounter++;
+            track++;
+            otherTrack++;
+        }
+    }
+
+    return sharedCounter;
+}
+
+void DuelingJP::growList(int minCapacity) {
+
+    // double the capacity so that repeated growth is amortized
+    int newCapacity = (listCapacity > 0) ? listCapacity * 2 : 1;
+    if (newCapacity < minCapacity) {
+        newCapacity = minCapacity;
+    }
+
+    // only reserved, so no JumpPrime (or prime search) is made for the
+    // spare entries
+    jumperList.reserve(newCapacity);
+
+    int *newMultiplicity = new int[newCapacity];
+    int *newGroupHandle = new int[newCapacity];
+    int *newPendingPosition = new int[newCapacity];
+    for (int i = 0; i < listSize; i++) {
+        newMultiplicity[i] = multiplicity[i];
+        newGroupHandle[i] = groupHandle[i];
+        newPendingPosition[i] = pendingPosition[i];
+    }
+
+    delete[] multiplicity;
+    delete[] groupHandle;
+    delete[] pendingPosition;
+    multiplicity = newMultiplicity;
+    groupHandle = newGroupHandle;
+    pendingPosition = newPendingPosition;
+    listCapacity = newCapacity;
+}
+
+int DuelingJP::newHandle(int groupNumber) {
+
+    int handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    } else {
+        handle = (int)handleGroup.size();
+        handleGroup.push_back(-1);
+        nextHandle.push_back(-1);
+    }
+
+    handleGroup[handle] = groupNumber;
+    nextHandle[handle] = groupHandle[groupNumber];
+    groupHandle[groupNumber] = handle;
+
+    return handle;
+}
+
+void DuelingJP::releaseHandles(int groupNumber) {
+
+    for (int handle = groupHandle[groupNumber]; handle >= 0; handle = nextHandle[handle]) {
+        handleGroup[handle] = -1;
+        freeHandles.push_back(handle);
+    }
+    groupHandle[groupNumber] = -1;
+}
+
+void DuelingJP::updatePending(int groupNumber) {
+
+    bool pending = jumperList[groupNumber].hasPendingJump();
+    int position = pendingPosition[groupNumber];
+
+    if (pending && (position < 0)) {
+        pendingPosition[groupNumber] = (int)pendingGroups.size();
+        pendingGroups.push_back(groupNumber);
+    } else if ((!pending) && (position >= 0)) {
+        dropPending(groupNumber);
+    }
+}
+
+void DuelingJP::dropPending(int groupNumber) {
+
+    int position = pendingPosition[groupNumber];
+    if (position < 0) {
+        return;
+    }
+
+    // fill the gap with the last entry so the queue stays contiguous
+    int lastGroup = pendingGroups.back();
+    pendingGroups[position] = lastGroup;
+    pendingPosition[lastGroup] = position;
+    pendingGroups.pop_back();
+    pendingPosition[groupNumber] = -1;
+}
+
+int DuelingJP::settlePending(int maxJumps) {
+
+    int settled = 0;
+
+    while ((settled < maxJumps) && !pendingGroups.empty()) {
+        int groupNumber = pendingGroups.back();
+        pendingGroups.pop_back();
+        pendingPosition[groupNumber] = -1;
+
+        if (jumperList[groupNumber].settleJump()) {
+            settled++;
+        }
+    }
+
+    return settled;
+}
+
+void DuelingJP::moveGroup(int from, int to) {
+
+    jumperList[to] = std::move(jumperList[from]);
+    multiplicity[to] = multiplicity[from];
+    groupHandle[to] = groupHandle[from];
+    pendingPosition[to] = pendingPosition[from];
+    if (pendingPosition[to] >= 0) {
+        pendingGroups[pendingPosition[to]] = to;
+    }
+
+    // a group only has the handles it was given or merged with, so this
+    // walk does not depend on the size of the list
+    for (int handle = groupHandle[to]; handle >= 0; handle = nextHandle[handle]) {
+        handleGroup[handle] = to;
+    }
+
+    auto initial = initialGroups.find(jumperList[to].getInitialValue());
+    if ((initial != initialGroups.end()) && (initial->second == from)) {
+        initial->second = to;
+    }
+}
+
+void DuelingJP::mergeIdenticalGroups() {
+
+    // positions of the groups kept so far, by initial value
+    std::unordered_multimap<unsigned int, int> keptIndex;
+    keptIndex.reserve(listSize);
+    int keptSize = 0;
+
+    for (int i = 0; i < listSize; i++) {
+        unsigned int initValue = jumperList[i].getInitialValue();
+
+        int match = -1;
+        auto range = keptIndex.equal_range(initValue);
+        for (auto entry = range.first; entry != range.second; ++entry) {
+            if (jumperList[entry->second] == jumperList[i]) {
+                match = entry->second;
+                break;
+            }
+        }
+
+        if (match >= 0) {
+            multiplicity[match] += multiplicity[i];
+
+            // hand the merged group's handles to the kept group
+            int lastHandle = groupHandle[i];
+            while (nextHandle[lastHandle] >= 0) {
+                handleGroup[lastHandle] = match;
+                lastHandle = nextHandle[lastHandle];
+            }
+            handleGroup[lastHandle] = match;
+            nextHandle[lastHandle] = groupHandle[match];
+            groupHandle[match] = groupHandle[i];
+        } else {
+            if (i != keptSize) {
+                moveGroup(i, keptSize);
+            }
+            keptIndex.emplace(initValue, keptSize);
+            keptSize++;
+        }
+    }
+
+    listSize = keptSize;
+    jumperList.erase(jumperList.begin() + keptSize, jumperList.end());
+
+    initialGroups.clear();
+    pendingGroups.clear();
+    for (int i = 0; i < listSize; i++) {
+        if (jumperList[i].isInitialState() || jumperList[i].isDisabled()) {
+            initialGroups[jumperList[i].getInitialValue()] = i;
+        }
+        pendingPosition[i] = -1;
+        updatePending(i);
+    }
+}
+
+void DuelingJP::removeGroup(int groupNumber) {
+
+    // drops the index entry for the group at position groupNumber
+    auto initial = initialGroups.find(jumperList[groupNumber].getInitialValue());
+    if ((initial != initialGroups.end()) && (initial->second == groupNumber)) {
+        initialGroups.erase(initial);
+    }
+    releaseHandles(groupNumber);
+    dropPending(groupNumber);
+
+    // fill the gap with the last group so the list stays contiguous
+    listSize--;
+    if (groupNumber != listSize) {
+        moveGroup(listSize, groupNumber);
+    }
+    jumperList.pop_back();
+}
+
+
+// assumption: all values in initValues are valid
+DuelingJP::DuelingJP(const int *initValues, int size, int *handles) {
+
+    multiplicity = nullptr;
+    groupHandle = nullptr;
+    pendingPosition = nullptr;
+    listSize = 0;
+    listCapacity = 0;
+    populationSize = 0;
+    deferJumps = false;
+    settlePerQuery = 0;
+    trace = nullptr;
+
+    // identical values share a group, so the list grows with the number of
+    // distinct groups rather than with size
+    for (int i = 0; i < size; i++) {
+        int handle = addJumper(initValues[i]);
+        if (handles != nullptr) {
+            handles[i] = handle;
+        }
     }
 }
 
 
 DuelingJP::~DuelingJP() {
-    delete jumperList;
+    delete[] multiplicity;
+    delete[] groupHandle;
+    delete[] pendingPosition;
+    delete trace;
 
 }
 
@@ -64,10 +453,27 @@ DuelingJP::DuelingJP(DuelingJP &sourceObject) {
 
     // copy list size
     listSize = sourceObject.listSize;
+    listCapacity = sourceObject.listSize;
+    populationSize = sourceObject.populationSize;
+    deferJumps = sourceObject.deferJumps;
+    settlePerQuery = sourceObject.settlePerQuery;
+    pendingGroups = sourceObject.pendingGroups;
+    initialGroups = sourceObject.initialGroups;
+    handleGroup = sourceObject.handleGroup;
+    nextHandle = sourceObject.nextHandle;
+    freeHandles = sourceObject.freeHandles;
+
+    // the trace belongs to the source object
+    trace = nullptr;
 
-    jumperList = new JumpPrime[listSize];
+    jumperList = sourceObject.jumperList;
+    multiplicity = new int[listCapacity];
+    groupHandle = new int[listCapacity];
+    pendingPosition = new int[listCapacity];
     for (int i = 0; i < listSize; i++) {
-        jumperList[i] = sourceObject.jumperList[i];
+        multiplicity[i] = sourceObject.multiplicity[i];
+        groupHandle[i] = sourceObject.groupHandle[i];
+        pendingPosition[i] = sourceObject.pendingPosition[i];
     }
 
 }
@@ -76,11 +482,36 @@ DuelingJP::DuelingJP(DuelingJP &&sourceObject) {
 
     // copy parameters
     listSize = sourceObject.listSize;
-    jumperList = sourceObject.jumperList;
+    listCapacity = sourceObject.listCapacity;
+    populationSize = sourceObject.populationSize;
+    deferJumps = sourceObject.deferJumps;
+    settlePerQuery = sourceObject.settlePerQuery;
+    jumperList = std::move(sourceObject.jumperList);
+    multiplicity = sourceObject.multiplicity;
+    groupHandle = sourceObject.groupHandle;
+    pendingPosition = sourceObject.pendingPosition;
+    trace = sourceObject.trace;
+    initialGroups = std::move(sourceObject.initialGroups);
+    handleGroup = std::move(sourceObject.handleGroup);
+    nextHandle = std::move(sourceObject.nextHandle);
+    freeHandles = std::move(sourceObject.freeHandles);
+    pendingGroups = std::move(sourceObject.pendingGroups);
+    sortedValues = std::move(sourceObject.sortedValues);
 
     // clear the source
     sourceObject.listSize = 0;
-    sourceObject.jumperList = nullptr;
+    sourceObject.listCapacity = 0;
+    sourceObject.populationSize = 0;
+    sourceObject.jumperList.clear();
+    sourceObject.multiplicity = nullptr;
+    sourceObject.groupHandle = nullptr;
+    sourceObject.pendingPosition = nullptr;
+    sourceObject.trace = nullptr;
+    sourceObject.initialGroups.clear();
+    sourceObject.handleGroup.clear();
+    sourceObject.nextHandle.clear();
+    sourceObject.freeHandles.clear();
+    sourceObject.pendingGroups.clear();
 
 
 
@@ -92,14 +523,35 @@ DuelingJP &DuelingJP::operator=(const DuelingJP &sourceObject) {
     // check to verify they're not the same object
     if (this != &sourceObject) {
 
-        // delete the old list of JumpPrime objects
-        delete this->jumperList;
+        // delete the old lists of group data
+        delete[] this->multiplicity;
+        delete[] this->groupHandle;
+        delete[] this->pendingPosition;
 
-        listSize = sourceObject.listSize;
+        // the old trace no longer matches the contents
+        delete this->trace;
+        trace = nullptr;
+        invalidateSorted();
 
-        jumperList = new JumpPrime[listSize];
+        listSize = sourceObject.listSize;
+        listCapacity = sourceObject.listSize;
+        populationSize = sourceObject.populationSize;
+        deferJumps = sourceObject.deferJumps;
+        settlePerQuery = sourceObject.settlePerQuery;
+        pendingGroups = sourceObject.pendingGroups;
+        initialGroups = sourceObject.initialGroups;
+        handleGroup = sourceObject.handleGroup;
+        nextHandle = sourceObject.nextHandle;
+        freeHandles = sourceObject.freeHandles;
+
+        jumperList = sourceObject.jumperList;
+        multiplicity = new int[listCapacity];
+        groupHandle = new int[listCapacity];
+        pendingPosition = new int[listCapacity];
         for (int i = 0; i < listSize; i++) {
-            jumperList[i] = sourceObject.jumperList[i];
+            multiplicity[i] = sourceObject.multiplicity[i];
+            groupHandle[i] = sourceObject.groupHandle[i];
+            pendingPosition[i] = sourceObject.pendingPosition[i];
         }
 
     }
@@ -113,7 +565,21 @@ DuelingJP &DuelingJP::operator=(DuelingJP &&sourceObject) {
 
     // swap contents
     std::swap(listSize, sourceObject.listSize);
+    std::swap(listCapacity, sourceObject.listCapacity);
+    std::swap(populationSize, sourceObject.populationSize);
+    std::swap(deferJumps, sourceObject.deferJumps);
+    std::swap(settlePerQuery, sourceObject.settlePerQuery);
     std::swap(jumperList, sourceObject.jumperList);
+    std::swap(multiplicity, sourceObject.multiplicity);
+    std::swap(groupHandle, sourceObject.groupHandle);
+    std::swap(pendingPosition, sourceObject.pendingPosition);
+    std::swap(trace, sourceObject.trace);
+    std::swap(initialGroups, sourceObject.initialGroups);
+    std::swap(handleGroup, sourceObject.handleGroup);
+    std::swap(nextHandle, sourceObject.nextHandle);
+    std::swap(freeHandles, sourceObject.freeHandles);
+    std::swap(pendingGroups, sourceObject.pendingGroups);
+    std::swap(sortedValues, sourceObject.sortedValues);
 
 
 
@@ -122,84 +588,337 @@ DuelingJP &DuelingJP::operator=(DuelingJP &&sourceObject) {
 
 int DuelingJP::countCollisions(bool testUp) {
 
-    struct CollisionCounter {
-        unsigned int value = 0;
-        int count = 0;
-    };
+    settlePending(settlePerQuery);
 
-    CollisionCounter *collisionCounter = new CollisionCounter[listSize];
+    std::vector<ValueCount> values;
+    values.reserve(listSize);
 
+    queryValues(testUp, values);
+    sortValues(values);
 
-    for (int i = 0; i < listSize; i++) {
-        unsigned int outputValue;
-        testJumper(i);
-        outputValue = testUp ?
-                jumperList[i].up() :
-                jumperList[i].down();
+    int returnCount = (int)tallyCollisions(values);
+
+    if (trace != nullptr) {
+        trace->record(testUp ? OpTrace::CountCollisionsUp :
+                      OpTrace::CountCollisionsDown, 0, returnCount);
+    }
+
+    return returnCount;
+}
+
+long long DuelingJP::countInversions() {
+
+    settlePending(settlePerQuery);
+
+    std::vector<ValueCount> upValues;
+    std::vector<ValueCount> downValues;
+    upValues.reserve(listSize);
+    downValues.reserve(listSize);
+
+    queryInversionValues(upValues, downValues);
+    sortValues(upValues);
+    sortValues(downValues);
+
+    long long inversionCounter = tallyInversions(upValues, downValues);
+
+    if (trace != nullptr) {
+        trace->record(OpTrace::CountInversions, 0, inversionCounter);
+    }
+
+    return inversionCounter;
+}
+
+
+int DuelingJP::peekCollisions(bool testUp) const {
+
+    std::vector<ValueCount> values;
+    values.reserve(listSize);
+    peekValues(testUp, 0, listSize, values);
+    sortValues(values);
+
+    return (int)tallyCollisions(values);
+}
+
+long long DuelingJP::peekInversions() const {
 
-        /// For determining where in the count array to store count
-        int countIndex = 0;
+    std::vector<ValueCount> upValues;
+    std::vector<ValueCount> downValues;
+    upValues.reserve(listSize);
+    downValues.reserve(listSize);
 
-        // move through array until either a 0 value or equal value
-        while ((collisionCounter[countIndex].value > 0) &&
-               (collisionCounter[countIndex].value != outputValue)) {
-            countIndex++;
+    peekValues(true, 0, listSize, upValues);
+    peekValues(false, 0, listSize, downValues);
+    sortValues(upValues);
+    sortValues(downValues);
+
+    return tallyInversions(upValues, downValues);
+}
+
+std::shared_ptr<const DuelingJP::SortedValues> DuelingJP::getSortedValues() const {
+
+    std::lock_guard<std::mutex> lock(sortedMutex);
+
+    if (sortedValues == nullptr) {
+        std::shared_ptr<SortedValues> values = std::make_shared<SortedValues>();
+        values->upValues.reserve(listSize);
+        values->downValues.reserve(listSize);
+        peekValues(true, 0, listSize, values->upValues);
+        peekValues(false, 0, listSize, values->downValues);
+        sortValues(values->upValues);
+        sortValues(values->downValues);
+        sortedValues = values;
+    }
+
+    return sortedValues;
+}
+
+void DuelingJP::invalidateSorted() {
+    sortedValues.reset();
+}
+
+JoinResult DuelingJP::join(const DuelingJP &other) const {
+
+    // each side is peeked and sorted at most once between changes, then
+    // every count walks the sorted lists together. Each side is locked on
+    // its own, so joins in both directions cannot wait on each other.
+    std::shared_ptr<const SortedValues> values = getSortedValues();
+    std::shared_ptr<const SortedValues> otherValues = other.getSortedValues();
+
+    JoinResult result;
+    result.upCollisions = tallyShared(values->upValues, otherValues->upValues);
+    result.downCollisions = tallyShared(values->downValues,
+                                        otherValues->downValues);
+    result.inversions =
+            tallyInversions(values->upValues, otherValues->downValues) +
+            tallyInversions(otherValues->upValues, values->downValues);
+
+    return result;
+}
+
+
+int DuelingJP::addJumper(int initValue) {
+
+    int groupNumber = -1;
+
+    // an untouched JumpPrime with the same initial value is identical to a
+    // new one, so no new JumpPrime (or prime search) is needed. A new
+    // JumpPrime is always untouched or disabled, so no other group can match.
+    auto initial = initialGroups.find(initValue);
+    if (initial != initialGroups.end()) {
+        JumpPrime &candidate = jumperList[initial->second];
+        if (candidate.isInitialState() || candidate.isDisabled()) {
+            groupNumber = initial->second;
+        } else {
+            // queried since it was indexed
+            initialGroups.erase(initial);
         }
+    }
 
-        collisionCounter[countIndex].value = outputValue;
-        collisionCounter[countIndex].count++;
+    if (groupNumber < 0) {
+        if (listSize == listCapacity) {
+            growList(listSize + 1);
+        }
 
+        groupNumber = listSize;
+        jumperList.emplace_back(initValue);
+        multiplicity[groupNumber] = 0;
+        groupHandle[groupNumber] = -1;
+        pendingPosition[groupNumber] = -1;
+        newHandle(groupNumber);
+        initialGroups[jumperList[groupNumber].getInitialValue()] = groupNumber;
+        listSize++;
     }
 
-    // now count how many values had collisions
-    int returnCount = 0;
+    multiplicity[groupNumber]++;
+    populationSize++;
+    invalidateSorted();
+
+    if (trace != nullptr) {
+        trace->record(OpTrace::AddJumper, initValue, groupHandle[groupNumber]);
+    }
+
+    return groupHandle[groupNumber];
+}
+
+bool DuelingJP::removeJumper(int handle) {
+
+    int groupNumber = -1;
+    if ((handle >= 0) && (handle < (int)handleGroup.size())) {
+        groupNumber = handleGroup[handle];
+    }
+
+    if (trace != nullptr) {
+        trace->record(OpTrace::RemoveJumper, handle, groupNumber >= 0);
+    }
 
+    if (groupNumber < 0) {
+        return false;
+    }
+
+    populationSize--;
+    multiplicity[groupNumber]--;
+    invalidateSorted();
+    if (multiplicity[groupNumber] == 0) {
+        removeGroup(groupNumber);
+    }
+
+    return true;
+}
+
+void DuelingJP::setDeferredJumps(bool deferred, int settleCount) {
+
+    if (trace != nullptr) {
+        trace->record(OpTrace::SetDeferredJumps, deferred, settleCount);
+    }
+
+    deferJumps = deferred;
+    settlePerQuery = (settleCount > 0) ? settleCount : 0;
+}
+
+int DuelingJP::settleJumps(int maxJumps) {
+
+    int settled = settlePending(maxJumps);
+
+    if (trace != nullptr) {
+        trace->record(OpTrace::SettleJumps, maxJumps, settled);
+    }
+
+    return settled;
+}
+
+int DuelingJP::resetAll(int threads) {
+
+    // every group with the same initial value resets to the same state, so
+    // one copy per initial value is reset and then copied to the others
+    std::unordered_map<unsigned int, int> freshIndex;
+    std::vector<JumpPrime> freshList;
     for (int i = 0; i < listSize; i++) {
-        if (collisionCounter[i].count > 0) {
-            returnCount = returnCount + collisionCounter[i].count - 1;
+        if (jumperList[i].isDisabled()) {
+            continue;
+        }
+        auto inserted = freshIndex.emplace(jumperList[i].getInitialValue(),
+                                           (int)freshList.size());
+        if (inserted.second) {
+            freshList.push_back(jumperList[i]);
+        } else if (jumperList[i].isInitialState()) {
+            // a group that was never queried needs no new prime search
+            freshList[inserted.first->second] = jumperList[i];
         }
     }
 
-    delete[] collisionCounter;
+    runParallel((int)freshList.size(), threads, [&](int begin, int end) {
+        for (int k = begin; k < end; k++) {
+            if ((!freshList[k].isInitialState()) || freshList[k].hasPendingJump()) {
+                freshList[k].reset();
+            }
+        }
+    });
 
-    return returnCount;
-}
+    int resetCount = 0;
+    for (int i = 0; i < listSize; i++) {
+        if (!jumperList[i].isDisabled()) {
+            jumperList[i] = freshList[freshIndex[jumperList[i].getInitialValue()]];
+            resetCount += multiplicity[i];
+        }
+    }
 
-int DuelingJP::countInversions() {
+    mergeIdenticalGroups();
+    invalidateSorted();
 
+    if (trace != nullptr) {
+        trace->record(OpTrace::ResetAll, 0, resetCount);
+    }
+
+    return resetCount;
+}
 
-    unsigned int *upCount = new unsigned int[listSize];
-    unsigned int *downCount = new unsigned int[listSize];
+int DuelingJP::reviveAll(int threads) {
 
+    int reviveCount = 0;
     for (int i = 0; i < listSize; i++) {
-        // In case the JumpPrime was inactive
-        testJumper(i);
-        upCount[i] = jumperList[i].up();
+        // reviving an active JumpPrime would disable it
+        if ((!jumperList[i].isActive()) && (!jumperList[i].isDisabled())) {
+            jumperList[i].revive();
+            reviveCount += multiplicity[i];
+        }
+    }
 
-        // In case the up jump deactivated it
-        testJumper(i);
-        downCount[i] = jumperList[i].down();
+    // groups that deactivated at the same number are now identical, and
+    // merging them first saves their prime searches
+    if (reviveCount > 0) {
+        mergeIdenticalGroups();
+        invalidateSorted();
     }
 
-    int inversionCounter = 0;
+    // every deferred jump is settled below
+    std::vector<int> pendingList;
+    pendingList.swap(pendingGroups);
+    for (int groupNumber : pendingList) {
+        pendingPosition[groupNumber] = -1;
+    }
 
-    for (int upTrack = 0; upTrack < listSize; upTrack++) {
-        for (int downTrack = 0; downTrack < listSize; downTrack++) {
-            if (upCount[upTrack] == downCount[downTrack]) {
-                inversionCounter++;
-            }
+    runParallel((int)pendingList.size(), threads, [&](int begin, int end) {
+        for (int k = begin; k < end; k++) {
+            jumperList[pendingList[k]].settleJump();
         }
+    });
+
+    if (trace != nullptr) {
+        trace->record(OpTrace::ReviveAll, 0, reviveCount);
     }
 
-    delete[] upCount;
-    delete[] downCount;
+    return reviveCount;
+}
+
+bool DuelingJP::startTrace(int capacity) {
 
-    return inversionCounter;
+    for (int i = 0; i < listSize; i++) {
+        if (!(jumperList[i].isInitialState() || jumperList[i].isDisabled())) {
+            return false;
+        }
+    }
+
+    // a fresh DuelingJP object built from these values replays the trace
+    std::vector<int> initValues;
+    std::vector<OpTrace::HandleEntry> initHandles;
+    initValues.reserve(populationSize);
+    for (int i = 0; i < listSize; i++) {
+        for (int handle = groupHandle[i]; handle >= 0; handle = nextHandle[handle]) {
+            initHandles.push_back({handle, (int)initValues.size()});
+        }
+        initValues.insert(initValues.end(), multiplicity[i],
+                          (int)jumperList[i].getInitialValue());
+    }
+
+    delete trace;
+    trace = new OpTrace(capacity, initValues, initHandles);
+
+    // the replay object starts with deferred jumps off
+    if (deferJumps || (settlePerQuery > 0)) {
+        trace->record(OpTrace::SetDeferredJumps, deferJumps, settlePerQuery);
+    }
+
+    return true;
 }
 
+void DuelingJP::stopTrace() {
+    delete trace;
+    trace = nullptr;
+}
 
+bool DuelingJP::dumpTrace(const char *path) const {
+    if (trace == nullptr) {
+        return false;
+    }
+
+    return trace->dump(path);
+}
 
 int DuelingJP::getSize() const {
+    return populationSize;
+}
+
+int DuelingJP::getDistinctSize() const {
     return listSize;
 }
 
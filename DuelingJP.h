@@ -5,8 +5,26 @@
 #ifndef INC_5011_P2_DUELINGJP_H
 #define INC_5011_P2_DUELINGJP_H
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include "JumpPrime.h"
 
+class OpTrace;
+
+/// JoinResult holds the counts between the JumpPrime objects of two
+/// DuelingJP objects, as computed by DuelingJP::join.
+struct JoinResult {
+    /// The number of up() values produced by both DuelingJP objects.
+    int upCollisions = 0;
+    /// The number of down() values produced by both DuelingJP objects.
+    int downCollisions = 0;
+    /// The number of pairs, one JumpPrime from each DuelingJP object, where
+    /// the up() value of one equals the down() value of the other.
+    long long inversions = 0;
+};
+
 
 /*
  * The DuelingJP encapsulates a series of JumpPrime objects, specified when
@@ -19,15 +37,50 @@
  * METHODS:
  * 1. The constructor accepts an array of integers representing the number
  * to be encapsulated by each JumpPrime object and an integer representing
- * the number of items in the array. Once a DuelingJP object is instanced,
- * the size and value of the JumpPrime objects cannot be changed by the user.
- * 2. countCollisions is used to count the number of collisions across all of
+ * the number of items in the array.
+ * 2. addJumper and removeJumper change the membership of an existing
+ * DuelingJP object one JumpPrime object at a time. The other JumpPrime
+ * objects keep their current state. addJumper returns a handle that
+ * removeJumper accepts; handles stay valid while groups are moved or
+ * merged. Storage grows geometrically, so a membership change costs O(1)
+ * amortized.
+ * 3. Identical JumpPrime objects (same values and same state) are stored
+ * once, together with the number of objects they stand for. Since every
+ * member of such a group receives the same calls, the members never
+ * diverge; removing one only lowers the count.
+ * 4. setDeferredJumps turns on a mode in which a query that makes a
+ * JumpPrime object jump returns without searching for the new nearest
+ * primes. The JumpPrime objects with a search outstanding are queued, and
+ * settleJumps finishes a limited number of those searches from the queue,
+ * so the work can be spread across later calls or run between query
+ * passes. The mode can also settle a fixed number at the start of every
+ * query. Any search not yet finished runs on the next query of that
+ * JumpPrime object, which only searches for the prime it returns. In
+ * countInversions, the down() that follows an up() which jumped finds only
+ * the new lower prime, leaving the upper prime search queued. Results are
+ * the same in both modes.
+ * 5. resetAll and reviveAll reset or revive every JumpPrime object at
+ * once. The prime searches are made once per distinct initial value (or
+ * per distinct group) and spread across threads, and groups that become
+ * identical are merged, so the next query finds every JumpPrime ready.
+ * 6. startTrace records every later operation on the object in an OpTrace
+ * buffer, and dumpTrace writes that trace to disk for replay.
+ * 7. countCollisions is used to count the number of collisions across all of
  * the JumpPrime objects stored in the DuelingJP object. This can be done
  * either in the up() direction or the down() direction.
- * 3. countInversions is used to count the number of inversions across all of
+ * 8. countInversions is used to count the number of inversions across all of
  * the JumpPrime objects stored in the DuelingJP object.This results in two
  * activations of each JumpPrime object in the DuelingJP object (once in the
  * up() direction and once in the down() direction).
+ * 9. peekCollisions and peekInversions answer the same questions as
+ * countCollisions and countInversions without changing any JumpPrime
+ * object. They are const and may be called from many threads at once.
+ * 10. join compares two DuelingJP objects, counting collisions and inversions
+ * between a JumpPrime object of one and a JumpPrime object of the other.
+ * The counts equal those of a DuelingJP object holding both populations,
+ * less the counts of each population on its own. Each object keeps the
+ * sorted values join uses until one of its JumpPrime objects changes, so
+ * repeated joins against an unchanged object do not peek it again.
  *
  * ASSUMPTIONS:
  * 1. When counting collisions, a single JumpPrime object returning a specific
@@ -49,12 +102,115 @@
 /// DuelingJP is a container for JumpPrime objects used for testing.
 class DuelingJP {
 
-    /// Pointer to array of JumpPrime objects of size listSize.
-    JumpPrime *jumperList;
+    // runs the peek helpers on ranges of jumperList from many threads
+    friend class BatchEvaluator;
+
+    // runs the query helpers in worker processes and merges their values
+    friend class ShardedDuel;
+
+    /// The distinct JumpPrime objects, listSize of them. Spare capacity is
+    /// reserved rather than constructed, since constructing a JumpPrime
+    /// searches for primes.
+    std::vector<JumpPrime> jumperList;
+
+    /// Pointer to array holding how many identical JumpPrime objects each
+    /// entry of jumperList stands for.
+    int *multiplicity;
+
+    /// Pointer to array holding, for each entry of jumperList, the first of
+    /// the handles that refer to it (the rest follow through nextHandle).
+    int *groupHandle;
 
-    /// The size of the jumperList array.
+    /// Pointer to array holding, for each entry of jumperList, its position
+    /// in pendingGroups, or -1 if it has no deferred jump.
+    int *pendingPosition;
+
+    /// The number of distinct JumpPrime objects in the jumperList array.
     int listSize;
 
+    /// The number of entries the jumperList and multiplicity arrays can hold
+    /// before they must be reallocated.
+    int listCapacity;
+
+    /// The total number of JumpPrime objects, counting duplicates.
+    int populationSize;
+
+    /// True if queries defer the prime search of any jump they cause.
+    bool deferJumps;
+
+    /// The number of deferred jumps settled at the start of each query.
+    int settlePerQuery;
+
+    /// The positions in jumperList of the entries with a deferred jump.
+    std::vector<int> pendingGroups;
+
+    /// The trace of operations on this object, or nullptr when not tracing.
+    OpTrace *trace;
+
+    /// Maps an initial value to the position in jumperList of the group
+    /// that was last seen in its initial state. A new JumpPrime object can
+    /// only be identical to that group, so addJumper needs no other search.
+    /// Entries are checked when used, since queries change the groups.
+    std::unordered_map<unsigned int, int> initialGroups;
+
+    /// The position in jumperList each handle refers to, or -1 for a handle
+    /// that is not in use.
+    std::vector<int> handleGroup;
+
+    /// The next handle that refers to the same group, or -1.
+    std::vector<int> nextHandle;
+
+    /// Handles that are not in use, for reuse.
+    std::vector<int> freeHandles;
+
+    /// growList reserves room in jumperList and reallocates the arrays that
+    /// parallel it with at least the requested capacity, moving the existing
+    /// entries into the new arrays.
+    /// @param [in] minCapacity The minimum capacity of the new arrays.
+    void growList(int minCapacity);
+
+    /// newHandle adds a handle to an entry of jumperList.
+    /// @param [in] groupNumber The position in jumperList.
+    /// @return The new handle.
+    int newHandle(int groupNumber);
+
+    /// releaseHandles frees every handle that refers to an entry of
+    /// jumperList.
+    /// @param [in] groupNumber The position in jumperList.
+    void releaseHandles(int groupNumber);
+
+    /// moveGroup moves an entry of jumperList to another position, updating
+    /// its handles, its initialGroups entry and its pendingGroups entry.
+    /// @param [in] from The current position in jumperList.
+    /// @param [in] to The new position in jumperList.
+    void moveGroup(int from, int to);
+
+    /// updatePending adds an entry of jumperList to pendingGroups, or
+    /// removes it, to match whether it has a deferred jump.
+    /// @param [in] groupNumber The position in jumperList.
+    void updatePending(int groupNumber);
+
+    /// dropPending removes an entry of jumperList from pendingGroups, if it
+    /// is there.
+    /// @param [in] groupNumber The position in jumperList.
+    void dropPending(int groupNumber);
+
+    /// settlePending finishes deferred jumps from the end of
+    /// pendingGroups.
+    /// @param [in] maxJumps The maximum number of jumps to settle.
+    /// @return The number of deferred jumps settled.
+    int settlePending(int maxJumps);
+
+    /// mergeIdenticalGroups merges entries of jumperList that have become
+    /// identical, keeping the first of each and rebuilding initialGroups.
+    /// The handles of a merged entry refer to the kept entry afterwards.
+    void mergeIdenticalGroups();
+
+    /// removeGroup removes an entry from jumperList. The last entry is moved
+    /// into the vacated position.
+    /// @param [in] groupNumber The position in jumperList to remove.
+    void removeGroup(int groupNumber);
+
     /// areActive verifies that all JumpPrime objects are currently active
     /// (i.e., they have not been deactivated).
     /// @return true if all of the member JumpPrime objects are active.
@@ -73,14 +229,96 @@ class DuelingJP {
     /// active and ready for use
     bool testJumper(int jumperNumber);
 
+    /// ValueCount pairs a value returned by JumpPrime objects with the number
+    /// of JumpPrime objects that returned it.
+    struct ValueCount {
+        unsigned int value;
+        int count;
+    };
+
+    /// peekValues collects the values the distinct JumpPrime objects in a
+    /// range of jumperList would return, without changing them.
+    /// @param [in] testUp If true, collects up() values, otherwise down().
+    /// @param [in] begin The first position in jumperList.
+    /// @param [in] end One past the last position in jumperList.
+    /// @param [out] values Receives one ValueCount per distinct JumpPrime.
+    void peekValues(bool testUp, int begin, int end,
+                    std::vector<ValueCount> &values) const;
+
+    /// queryValues queries every distinct JumpPrime object once, reviving
+    /// any that were deactivated, and collects the values returned.
+    /// @param [in] testUp If true, calls up(), otherwise down().
+    /// @param [out] values Receives one ValueCount per distinct JumpPrime.
+    void queryValues(bool testUp, std::vector<ValueCount> &values);
+
+    /// queryInversionValues calls up() and then down() on every distinct
+    /// JumpPrime object, as countInversions does, and collects both values.
+    /// A jump deferred by up() is only half settled by the down() after it.
+    /// @param [out] upValues Receives one up() ValueCount per JumpPrime.
+    /// @param [out] downValues Receives one down() ValueCount per JumpPrime.
+    void queryInversionValues(std::vector<ValueCount> &upValues,
+                              std::vector<ValueCount> &downValues);
+
+    /// sortValues sorts a list of ValueCount entries by value and merges
+    /// entries with the same value.
+    /// @param [in,out] values The list to sort and merge.
+    static void sortValues(std::vector<ValueCount> &values);
+
+    /// tallyCollisions counts the collisions in a sorted, merged list.
+    /// @param [in] values The list produced by sortValues.
+    /// @return The number of collisions.
+    static long long tallyCollisions(const std::vector<ValueCount> &values);
+
+    /// tallyInversions counts the inversions between two sorted, merged
+    /// lists of up() and down() values.
+    /// @param [in] upValues The up() values produced by sortValues.
+    /// @param [in] downValues The down() values produced by sortValues.
+    /// @return The number of inversions.
+    static long long tallyInversions(const std::vector<ValueCount> &upValues,
+                                     const std::vector<ValueCount> &downValues);
+
+    /// tallyShared counts the values that appear in both of two sorted,
+    /// merged lists.
+    /// @param [in] values The first list produced by sortValues.
+    /// @param [in] otherValues The second list produced by sortValues.
+    /// @return The number of values in both lists.
+    static long long tallyShared(const std::vector<ValueCount> &values,
+                                 const std::vector<ValueCount> &otherValues);
+
+    /// SortedValues holds the peeked up() and down() values of every
+    /// distinct JumpPrime object, each list sorted and merged.
+    struct SortedValues {
+        std::vector<ValueCount> upValues;
+        std::vector<ValueCount> downValues;
+    };
+
+    /// The sorted values join last used, or nullptr if any JumpPrime object
+    /// has changed since. The lists are never changed once built, so a join
+    /// still using them is unaffected when they are replaced.
+    mutable std::shared_ptr<const SortedValues> sortedValues;
+
+    /// Guards sortedValues, since join is const and may run on many threads.
+    mutable std::mutex sortedMutex;
+
+    /// getSortedValues returns the sorted values, peeking and sorting them
+    /// only if a JumpPrime object has changed since the last call.
+    /// @return The sorted up() and down() values.
+    std::shared_ptr<const SortedValues> getSortedValues() const;
+
+    /// invalidateSorted discards the sorted values after a JumpPrime object
+    /// may have changed.
+    void invalidateSorted();
+
 public:
 
     /// DuelingJP Constructor creates a new DuelingJP object with a set of
     /// JumpPrime objects specified by a given array of initial values.
     /// @param [in] initValues Array of initial values for JumpPrime objects
     /// @param [in] size The size of the array of initial values.
+    /// @param [out] handles If not nullptr, receives the handle of each
+    /// JumpPrime object, as addJumper would return it.
     /// @pre All values of array are valid JumpPrime initial values.
-    DuelingJP(const int *initValues, int size);
+    DuelingJP(const int *initValues, int size, int *handles = nullptr);
 
     /// DuelingJP Destructor for disposing of JumpPrime garbage
     ~DuelingJP();
@@ -120,14 +358,109 @@ public:
     /// coutInversions will go through both the up() and down() methods of
     /// every JumpPrime object in the DuelingJP object and count the number
     /// of unique times an up() result equals a down() result.
+    /// @return The number of JumpPrime object inversions, which can exceed
+    ///         the range of an int.
+    long long countInversions();
+
+    /// peekCollisions counts the collisions the next countCollisions call
+    /// would find, without changing any JumpPrime object.
+    /// @param [in] testUp If true, tests the "up" direction. Defaults to true.
+    /// @return The number of JumpPrime objects that would collide.
+    int peekCollisions(bool testUp = true) const;
+
+    /// peekInversions counts the inversions between the current up() and
+    /// down() results of every JumpPrime object, without changing any of
+    /// them. Unlike countInversions, no JumpPrime object can jump between
+    /// its up() and down() result.
     /// @return The number of JumpPrime object inversions.
-    int countInversions();
+    long long peekInversions() const;
+
+    /// join counts the collisions and inversions between the JumpPrime
+    /// objects of this DuelingJP and those of another, without changing
+    /// either. Like peekInversions, the current up() and down() results are
+    /// used.
+    /// @param [in] other The DuelingJP object to compare against.
+    /// @return The collision and inversion counts between the two objects.
+    JoinResult join(const DuelingJP &other) const;
+
+
+    /// addJumper appends a new JumpPrime object to this DuelingJP.
+    /// If an identical JumpPrime object is already stored, its count is
+    /// increased instead.
+    /// @param [in] initValue The initial value of the new JumpPrime object.
+    /// @return A handle for removeJumper. Identical JumpPrime objects may
+    /// share a handle.
+    /// @pre initValue is a valid JumpPrime initial value.
+    int addJumper(int initValue);
+
+    /// removeJumper removes one JumpPrime object of the group a handle
+    /// refers to. A handle may be passed once for each time it was returned;
+    /// after that it may be reused for another group.
+    /// @param [in] handle A handle returned by addJumper or the constructor.
+    /// @return true if a JumpPrime object was removed, false if the handle
+    /// is not in use.
+    bool removeJumper(int handle);
+
+    /// setDeferredJumps turns the deferred jump mode on or off.
+    /// @param [in] deferred If true, queries that make a JumpPrime object
+    /// jump return without searching for its new nearest primes.
+    /// @param [in] settleCount The number of deferred jumps settled at the
+    /// start of each countCollisions or countInversions call, which bounds
+    /// the backlog without a separate settleJumps call.
+    void setDeferredJumps(bool deferred, int settleCount = 0);
 
+    /// settleJumps finishes up to maxJumps deferred jumps from the queue.
+    /// Like the queries, it changes the JumpPrime objects, so it must not
+    /// run at the same time as any other call on this object. To settle
+    /// from a worker thread, hold the same lock the queries are made under
+    /// and settle a small batch at a time.
+    /// @param [in] maxJumps The maximum number of jumps to settle.
+    /// @return The number of deferred jumps settled.
+    int settleJumps(int maxJumps);
+
+    /// resetAll resets every JumpPrime object to its initial value, as
+    /// reset() would. Failed JumpPrime objects are left as they are.
+    /// @param [in] threads The number of threads used for the prime
+    /// searches, or 0 for one per hardware thread.
+    /// @return The number of JumpPrime objects reset.
+    int resetAll(int threads = 0);
+
+    /// reviveAll revives every deactivated JumpPrime object, as the next
+    /// query would, and settles every deferred jump.
+    /// @param [in] threads The number of threads used for the prime
+    /// searches, or 0 for one per hardware thread.
+    /// @return The number of JumpPrime objects revived.
+    int reviveAll(int threads = 0);
+
+    /// startTrace starts recording the operations on this DuelingJP. Any
+    /// trace already in progress is discarded. Copies of this object are not
+    /// traced. A replay starts from fresh JumpPrime objects, so tracing is
+    /// refused once any JumpPrime object has been queried.
+    /// @param [in] capacity The number of operations kept. Later operations
+    /// are counted as dropped.
+    /// @return true if tracing started, false if a JumpPrime object has
+    /// been queried since it was created or reset.
+    bool startTrace(int capacity);
+
+    /// stopTrace stops recording and discards the trace.
+    void stopTrace();
+
+    /// dumpTrace writes the trace to a binary file that the replay tool can
+    /// run against a fresh DuelingJP object.
+    /// @param [in] path The path of the file to write.
+    /// @return true if the file was written, false if not tracing or the
+    /// file could not be written.
+    bool dumpTrace(const char *path) const;
 
     /// getSize returns the number of JumpPrime objects in this DuelingJP.
     /// @return The number of JumpPrime objects in the DuelingJP object.
     int getSize() const;
 
+    /// getDistinctSize returns the number of distinct JumpPrime objects
+    /// stored by this DuelingJP.
+    /// @return The number of distinct JumpPrime objects.
+    int getDistinctSize() const;
+
 
 
 };
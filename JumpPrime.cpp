@@ -3,9 +3,14 @@
 // Revision: 2.0
 
 #include "JumpPrime.h"
+#include "PrimeIndex.h"
 
+static_assert(sizeof(JumpPrime) <= 16, "JumpPrime must stay packed");
 
-bool JumpPrime::isPrime(unsigned int testNumber) {
+const PrimeIndex *JumpPrime::primeIndex = nullptr;
+
+
+bool JumpPrime::isPrime(unsigned int testNumber) const {
 
     for (unsigned int i = 2; i < testNumber; i++) {
         if (testNumber % i == 0) {
@@ -16,7 +21,15 @@ bool JumpPrime::isPrime(unsigned int testNumber) {
     return true;
 }
 
-unsigned int JumpPrime::findPrime(unsigned int startValue, bool findNext) {
+unsigned int JumpPrime::findPrime(unsigned int startValue, bool findNext) const {
+    // look the prime up if it falls inside the range of the index
+    unsigned int indexedPrime;
+    if ((primeIndex != nullptr) &&
+        (findNext ? primeIndex->nextPrime(startValue, indexedPrime) :
+                    primeIndex->previousPrime(startValue, indexedPrime))) {
+        return indexedPrime;
+    }
+
     // determine if this needs to count up or down
     int stepValue = findNext ? 1 : -1;
 
@@ -31,22 +44,62 @@ unsigned int JumpPrime::findPrime(unsigned int startValue, bool findNext) {
 
 void JumpPrime::setPrimeLimits() {
 
-    upperPrime = findPrime(mainNumber, true);
-    lowerPrime = findPrime(mainNumber, false);
+    upperOffset = findPrime(mainNumber, true) - mainNumber;
+    lowerOffset = mainNumber - findPrime(mainNumber, false);
 
 }
 
+void JumpPrime::settleUpper() {
+    if (upperPending == 1) {
+        upperOffset = findPrime(mainNumber, true) - mainNumber;
+        upperPending = 0;
+    }
+}
+
+void JumpPrime::settleLower() {
+    if (lowerPending == 1) {
+        lowerOffset = mainNumber - findPrime(mainNumber, false);
+        lowerPending = 0;
+    }
+}
+
+bool JumpPrime::reachedQueryLimit() {
+    if (queryCount < 2) {
+        return false;
+    }
+
+    settleJump();
+    return queryCount >= queryLimit();
+}
+
+unsigned int JumpPrime::upperPrime() const {
+    return mainNumber + upperOffset;
+}
+
+unsigned int JumpPrime::lowerPrime() const {
+    return mainNumber - lowerOffset;
+}
+
+unsigned int JumpPrime::queryLimit() const {
+    return upperOffset + lowerOffset;
+}
+
 void JumpPrime::resetQueryCounter() {
-    queryLimit = upperPrime - lowerPrime;
     queryCount = 0;
 }
 
-void JumpPrime::jumpNumber(int jumpValue) {
+void JumpPrime::jumpNumber(int jumpValue, bool deferJump) {
 
     // initiate the jump
     mainNumber = mainNumber + jumpValue;
 
-    setPrimeLimits();
+    if (deferJump) {
+        upperPending = 1;
+        lowerPending = 1;
+    }
+    else {
+        setPrimeLimits();
+    }
     resetQueryCounter();
 
     jumpCount++;
@@ -61,6 +114,16 @@ void JumpPrime::jumpNumber(int jumpValue) {
 
 JumpPrime::JumpPrime(unsigned int initValue, unsigned int jumpBound) {
 
+    initialNumber = initValue;
+    mainNumber = initValue;
+    upperOffset = 0;
+    lowerOffset = 0;
+    queryCount = 0;
+    jumpCount = 0;
+    upperPending = 0;
+    lowerPending = 0;
+    jumpLimit = (jumpBound < MAX_JUMP_BOUND) ? jumpBound : MAX_JUMP_BOUND;
+
     // less than four digits
     if (initValue < 1000) {
         currentState = Failed;
@@ -69,22 +132,24 @@ JumpPrime::JumpPrime(unsigned int initValue, unsigned int jumpBound) {
     // otherwise, proceed with initialization
     else {
         currentState = Active;
-        jumpLimit = jumpBound;
-        initialNumber = initValue;
         this->reset();
     }
 }
 
-unsigned int JumpPrime::up() {
+unsigned int JumpPrime::up(bool deferJump) {
     if (currentState == Active) {
+        // a deferred jump must find the upper prime before it can be
+        // returned; the lower one can stay deferred
+        settleUpper();
+
         // storing the upper prime in the case that the object jumps
         // after this query
-        unsigned int returnValue = upperPrime;
+        unsigned int returnValue = upperPrime();
 
         queryCount++;
 
-        if (queryCount >= queryLimit) {
-            jumpNumber(upperPrime + DEFAULT_JUMP_VALUE);
+        if (reachedQueryLimit()) {
+            jumpNumber(upperPrime() + DEFAULT_JUMP_VALUE, deferJump);
 
         }
 
@@ -94,16 +159,20 @@ unsigned int JumpPrime::up() {
 }
 
 
-unsigned int JumpPrime::down() {
+unsigned int JumpPrime::down(bool deferJump) {
     if (currentState == Active) {
-        // storing the upper prime in the case that the object jumps
+        // a deferred jump must find the lower prime before it can be
+        // returned; the upper one can stay deferred
+        settleLower();
+
+        // storing the lower prime in the case that the object jumps
         // after this query
-        unsigned int returnValue = lowerPrime;
+        unsigned int returnValue = lowerPrime();
 
         queryCount++;
 
-        if (queryCount >= queryLimit) {
-            jumpNumber(lowerPrime - DEFAULT_JUMP_VALUE);
+        if (reachedQueryLimit()) {
+            jumpNumber(lowerPrime() - DEFAULT_JUMP_VALUE, deferJump);
         }
 
         return returnValue;
@@ -123,6 +192,8 @@ bool JumpPrime::reset() {
         mainNumber = initialNumber;
 
         setPrimeLimits();
+        upperPending = 0;
+        lowerPending = 0;
         resetQueryCounter();
 
         jumpCount = 0;
@@ -163,12 +234,69 @@ unsigned int JumpPrime::getCurrentValue() {
     return mainNumber;
 }
 
+unsigned int JumpPrime::peekUp() const {
+    if (currentState == Failed) {
+        return 0;
+    }
+
+    // a pending jump has no upper prime yet, so search without storing it
+    return (upperPending == 1) ? findPrime(mainNumber, true) : upperPrime();
+}
+
+unsigned int JumpPrime::peekDown() const {
+    if (currentState == Failed) {
+        return 0;
+    }
+
+    return (lowerPending == 1) ? findPrime(mainNumber, false) : lowerPrime();
+}
 
+bool JumpPrime::hasPendingJump() const {
+    return (upperPending == 1) || (lowerPending == 1);
+}
 
+bool JumpPrime::settleJump() {
+    if (!hasPendingJump()) {
+        return false;
+    }
 
+    settleUpper();
+    settleLower();
 
+    return true;
+}
 
+bool JumpPrime::isInitialState() const {
+    return (currentState == Active) && (mainNumber == initialNumber) &&
+           (jumpCount == 0) && (queryCount == 0);
+}
 
+unsigned int JumpPrime::getInitialValue() const {
+    return initialNumber;
+}
 
+void JumpPrime::setPrimeIndex(const PrimeIndex *index) {
+    primeIndex = index;
+}
 
+bool JumpPrime::operator==(const JumpPrime &other) const {
+    // a failed object never returns results, so the rest does not matter
+    if ((currentState == Failed) || (other.currentState == Failed)) {
+        return currentState == other.currentState;
+    }
 
+    // the nearest primes follow from mainNumber, so out of date offsets are
+    // not compared
+    bool offsetsMatch = ((upperPending == 1) || (other.upperPending == 1) ||
+                         (upperOffset == other.upperOffset)) &&
+                        ((lowerPending == 1) || (other.lowerPending == 1) ||
+                         (lowerOffset == other.lowerOffset));
+
+    return offsetsMatch &&
+           (initialNumber == other.initialNumber) &&
+           (mainNumber == other.mainNumber) &&
+           (currentState == other.currentState) &&
+           (queryCount == other.queryCount) &&
+           (jumpCount == other.jumpCount) &&
+           (jumpLimit == other.jumpLimit);
+}
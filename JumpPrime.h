@@ -5,6 +5,8 @@
 #ifndef INC_5011_P2_JUMPPRIME_H
 #define INC_5011_P2_JUMPPRIME_H
 
+class PrimeIndex;
+
 /*
  * The JumpPrime object encapsulates a positive integer that must be at
  * least 4 digits long. The user can query the object for the two nearest
@@ -42,6 +44,19 @@
  * next higher prime plus the default jump value. For a jump in the negative
  * direction, it jumps to the next lower prime minus the default jump value.
  * 3. The default jump value is specified as a class constant (here, 100).
+ * 4. The object is packed into 16 bytes. The nearest primes are stored as
+ * offsets from the encapsulated number and the counters as bit fields, so
+ * the jump bound cannot exceed MAX_JUMP_BOUND (here, 511). Larger bounds
+ * are reduced to it.
+ * 5. A jump may be deferred. The encapsulated number and the counters are
+ * updated right away, but the search for the new nearest primes is left
+ * for settleJump() or the next query. A query only finds the prime it
+ * returns, so an up() that jumps followed by a down() finds the new lower
+ * prime and leaves the upper one deferred. Results are the same as for an
+ * immediate jump.
+ * 6. A PrimeIndex may be installed for all JumpPrime objects with
+ * setPrimeIndex. Nearest primes inside its range are then looked up rather
+ * than searched for; values outside its range are still searched for.
  */
 
 /// The JumpPrime class encapsulates a positive integer and provides the
@@ -57,21 +72,50 @@ class JumpPrime {
     static const unsigned int DEFAULT_JUMP_BOUND = 10;
     static const unsigned int DEFAULT_INITIAL_VALUE = 9999;
     static const int DEFAULT_JUMP_VALUE = 100;
+    static const unsigned int MAX_JUMP_BOUND = 511;
+
+    // shared table of primes used by findPrime, if any
+    static const PrimeIndex *primeIndex;
 
     unsigned int initialNumber;
     unsigned int mainNumber;
 
-    // for tracking the object's state
-    Status currentState;
+    // distance from mainNumber to the nearest prime above and below it. Prime
+    // gaps within the range of an unsigned int are far smaller than 2^16.
+    unsigned short upperOffset;
+    unsigned short lowerOffset;
 
-    int queryCount;
-    int queryLimit;
+    // for tracking the object's state, packed into a single word. The query
+    // limit is not stored; it is the distance between the two nearest primes.
+    unsigned int currentState : 2;
+    unsigned int queryCount : 10;
+    unsigned int jumpCount : 9;
+    unsigned int jumpLimit : 9;
 
-    int jumpCount;
-    int jumpLimit;
+    // set when a deferred jump has not yet found its new nearest prime above
+    // or below mainNumber, in which case that offset is out of date. Each is
+    // found on its own, by the first query that needs it.
+    unsigned int upperPending : 1;
+    unsigned int lowerPending : 1;
 
-    unsigned int upperPrime;
-    unsigned int lowerPrime;
+    /**
+     * upperPrime returns the nearest prime number above mainNumber.
+     * @return the next highest prime number
+     */
+    unsigned int upperPrime() const;
+
+    /**
+     * lowerPrime returns the nearest prime number below mainNumber.
+     * @return the next lowest prime number
+     */
+    unsigned int lowerPrime() const;
+
+    /**
+     * queryLimit returns the number of queries the object answers before it
+     * jumps (the distance between the next and previous prime number).
+     * @return the number of queries before a jump
+     */
+    unsigned int queryLimit() const;
 
     /**
      * isPrime determines whether or not the given positive integer is a prime
@@ -80,7 +124,7 @@ class JumpPrime {
      * @param testNumber the positive integer to test
      * @return true if the number is prime, false otherwise
      */
-    bool isPrime(unsigned int testNumber);
+    bool isPrime(unsigned int testNumber) const;
 
     /**
      * findPrime finds either the next nearest prime number or the previous
@@ -92,7 +136,7 @@ class JumpPrime {
      * @return the next (or previous) positive prime integer within the bounds
      * of the unsigned integer date type
      */
-    unsigned int findPrime(unsigned int startValue, bool findNext);
+    unsigned int findPrime(unsigned int startValue, bool findNext) const;
 
     /**
      * setPrimeLimits finds a new upper and lower prime number based on the
@@ -101,8 +145,29 @@ class JumpPrime {
     void setPrimeLimits();
 
     /**
-     * resetQueryCounter sets the new query limits (based on the distance between
-     * the next and previosu prime number) and resets the query counter to 0.
+     * settleUpper finds the nearest prime above mainNumber if a deferred jump
+     * left it out of date. The lower prime is left as it is.
+     */
+    void settleUpper();
+
+    /**
+     * settleLower finds the nearest prime below mainNumber if a deferred jump
+     * left it out of date. The upper prime is left as it is.
+     */
+    void settleLower();
+
+    /**
+     * reachedQueryLimit determines whether the object has answered enough
+     * queries to jump. The nearest primes are at least two apart, so the
+     * first query after a jump never reaches the limit and does not need the
+     * prime it did not return.
+     * @return true if the object must jump now
+     */
+    bool reachedQueryLimit();
+
+    /**
+     * resetQueryCounter resets the query counter to 0. The query limit follows
+     * from the distance between the next and previous prime number.
      */
     void resetQueryCounter();
 
@@ -111,8 +176,10 @@ class JumpPrime {
      * specified amount. After a set number of "jumps", the JumpPrime will deactive.
      * @param jumpValue the value (positive or negative) to "jump" the stored
      * number by.
+     * @param deferJump true to leave the search for the new nearest primes
+     * for later.
      */
-    void jumpNumber(int jumpValue);
+    void jumpNumber(int jumpValue, bool deferJump);
 
 public:
     /**
@@ -131,21 +198,56 @@ public:
      * JumpPrime object. Does not return accurate results if the JumpPrime object
      * has been deactivated.
      * PRECONDITION: the JumpPrime object is running.
+     * @param deferJump true to defer the prime search if this query makes the
+     * object jump. Defaults to false.
      * @return the next highest prime number. If the JumpPrime object has been
      * deactivated, returns 0.
      */
-    unsigned int up();
+    unsigned int up(bool deferJump = false);
 
     /**
      * down returns the next lowest prime number from the number stored in the
      * JumpPrime object. Does not return accurate results if the JumpPrime
      * object has been deactivated.
      * PRECONDITION: the JumpPrime object is running.
+     * @param deferJump true to defer the prime search if this query makes the
+     * object jump. Defaults to false.
      * @return the next lowest prime number. If the JumpPrime object has been
      * deactivated, returns 0.
-     * @return
      */
-    unsigned int down();
+    unsigned int down(bool deferJump = false);
+
+    /**
+     * peekUp returns the prime number the next up() call would return, without
+     * changing the object. An inactive object reports the value it would
+     * return once revived.
+     * @return the next highest prime number. If the JumpPrime object has
+     * failed, returns 0.
+     */
+    unsigned int peekUp() const;
+
+    /**
+     * peekDown returns the prime number the next down() call would return,
+     * without changing the object. An inactive object reports the value it
+     * would return once revived.
+     * @return the next lowest prime number. If the JumpPrime object has
+     * failed, returns 0.
+     */
+    unsigned int peekDown() const;
+
+    /**
+     * hasPendingJump returns whether the JumpPrime object has a deferred jump
+     * whose new nearest primes have not been found yet.
+     * @return true if a deferred jump is waiting to be settled.
+     */
+    bool hasPendingJump() const;
+
+    /**
+     * settleJump finishes a deferred jump by finding the new nearest primes.
+     * Does nothing if no jump is pending.
+     * @return true if a pending jump was settled, false otherwise.
+     */
+    bool settleJump();
 
     /**
      * Reset attempts to reset the JumpPrime object to the original integer
@@ -190,6 +292,38 @@ public:
      */
     unsigned int getCurrentValue();
 
+    /**
+     * isInitialState returns whether the JumpPrime object is in the state it
+     * was in right after it was instantiated or reset.
+     * @return true if the object has not been queried since instantiation or
+     * its last reset.
+     */
+    bool isInitialState() const;
+
+    /**
+     * getInitialValue returns the value the JumpPrime object was instantiated
+     * with (i.e., the value it returns to when reset).
+     * @return the initial value encapsulated by the JumpPrime object.
+     */
+    unsigned int getInitialValue() const;
+
+    /**
+     * setPrimeIndex installs a table of primes used by every JumpPrime object
+     * to find its nearest primes. The table must outlive its use and should
+     * not be changed while JumpPrime objects are being queried.
+     * @param index the table of primes, or nullptr to search for every prime
+     */
+    static void setPrimeIndex(const PrimeIndex *index);
+
+    /**
+     * Two JumpPrime objects are equal if they encapsulate the same values and
+     * are in the same state. Equal JumpPrime objects return the same results
+     * for any identical sequence of method calls.
+     * @param other the JumpPrime object to compare against
+     * @return true if the two JumpPrime objects are identical.
+     */
+    bool operator==(const JumpPrime &other) const;
+
 
 };
 
@@ -0,0 +1,164 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#include <cstring>
+#include <fstream>
+#include "OpTrace.h"
+
+static_assert(sizeof(OpTrace::Record) == 24, "trace records must stay compact");
+
+namespace {
+
+    /// TraceHeader starts every trace file.
+    struct TraceHeader {
+        char magic[4];
+        unsigned int version;
+        unsigned int initCount;
+        unsigned int handleCount;
+        unsigned int recordCount;
+        unsigned long long droppedCount;
+    };
+
+    const char TRACE_MAGIC[4] = {'D', 'J', 'P', 'T'};
+    const unsigned int TRACE_VERSION = 3;
+
+}
+
+
+OpTrace::OpTrace(int capacity, const std::vector<int> &initValues,
+                 const std::vector<HandleEntry> &initHandles)
+        : recordCount(0), initialValues(initValues), initialHandles(initHandles),
+          startTime(std::chrono::steady_clock::now()) {
+
+    recordList.resize((capacity > 0) ? capacity : 0);
+}
+
+void OpTrace::record(Operation operation, int argument, long long result) {
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime);
+
+    unsigned long long slot =
+            recordCount.fetch_add(1, std::memory_order_relaxed);
+
+    // keeping the oldest records keeps the trace replayable from the
+    // initial values; the rest are only counted
+    if (slot >= recordList.size()) {
+        return;
+    }
+    Record &newRecord = recordList[slot];
+
+    newRecord.timeOffset = (unsigned int)elapsed.count();
+    newRecord.operation = operation;
+    std::memset(newRecord.reserved, 0, sizeof(newRecord.reserved));
+    newRecord.argument = argument;
+    newRecord.result = result;
+}
+
+unsigned long long OpTrace::getDroppedCount() const {
+    unsigned long long total = recordCount.load(std::memory_order_acquire);
+    return (total > recordList.size()) ? total - recordList.size() : 0;
+}
+
+bool OpTrace::dump(const char *path) const {
+
+    std::ofstream traceFile(path, std::ios::binary | std::ios::trunc);
+    if (!traceFile) {
+        return false;
+    }
+
+    unsigned long long total = recordCount.load(std::memory_order_acquire);
+    unsigned long long dropped = getDroppedCount();
+
+    TraceHeader header{};
+    std::memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.initCount = initialValues.size();
+    header.handleCount = initialHandles.size();
+    header.recordCount = total - dropped;
+    header.droppedCount = dropped;
+
+    traceFile.write((const char *)&header, sizeof(header));
+    traceFile.write((const char *)initialValues.data(),
+                    initialValues.size() * sizeof(int));
+    traceFile.write((const char *)initialHandles.data(),
+                    initialHandles.size() * sizeof(HandleEntry));
+
+    traceFile.write((const char *)recordList.data(),
+                    (total - dropped) * sizeof(Record));
+
+    return (bool)traceFile;
+}
+
+bool OpTrace::load(const char *path, std::vector<int> &initValues,
+                   std::vector<HandleEntry> &initHandles,
+                   std::vector<Record> &records,
+                   unsigned long long &dropped) {
+
+    std::ifstream traceFile(path, std::ios::binary);
+    if (!traceFile) {
+        return false;
+    }
+
+    traceFile.seekg(0, std::ios::end);
+    unsigned long long fileSize = (unsigned long long)traceFile.tellg();
+    traceFile.seekg(0, std::ios::beg);
+
+    TraceHeader header{};
+    traceFile.read((char *)&header, sizeof(header));
+    if (!traceFile ||
+        (std::memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0) ||
+        (header.version != TRACE_VERSION)) {
+        return false;
+    }
+
+    // the counts must fit in the file before anything is sized from them
+    unsigned long long expectedSize =
+            sizeof(TraceHeader) +
+            (unsigned long long)header.initCount * sizeof(int) +
+            (unsigned long long)header.handleCount * sizeof(HandleEntry) +
+            (unsigned long long)header.recordCount * sizeof(Record);
+    if (fileSize < expectedSize) {
+        return false;
+    }
+
+    initValues.resize(header.initCount);
+    traceFile.read((char *)initValues.data(), header.initCount * sizeof(int));
+
+    initHandles.resize(header.handleCount);
+    traceFile.read((char *)initHandles.data(),
+                   header.handleCount * sizeof(HandleEntry));
+
+    records.resize(header.recordCount);
+    traceFile.read((char *)records.data(), header.recordCount * sizeof(Record));
+
+    dropped = header.droppedCount;
+
+    return (bool)traceFile;
+}
+
+const char *OpTrace::getOperationName(unsigned char operation) {
+
+    switch (operation) {
+        case CountCollisionsUp:
+            return "countCollisions(up)";
+        case CountCollisionsDown:
+            return "countCollisions(down)";
+        case CountInversions:
+            return "countInversions";
+        case AddJumper:
+            return "addJumper";
+        case RemoveJumper:
+            return "removeJumper";
+        case SetDeferredJumps:
+            return "setDeferredJumps";
+        case SettleJumps:
+            return "settleJumps";
+        case ResetAll:
+            return "resetAll";
+        case ReviveAll:
+            return "reviveAll";
+        default:
+            return "unknown";
+    }
+}
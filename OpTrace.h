@@ -0,0 +1,140 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#ifndef INC_5011_P2_OPTRACE_H
+#define INC_5011_P2_OPTRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+
+/*
+ * The OpTrace records the operations called on a DuelingJP object so that
+ * the same sequence can be replayed later against a fresh DuelingJP object.
+ * Each operation is stored as a fixed-size binary record in a buffer. When
+ * the buffer is full, later operations are counted but not stored, so the
+ * records kept are always an exact prefix of the run and replay against
+ * the initial values.
+ *
+ * METHODS:
+ * 1. The constructor accepts the capacity of the buffer, the initial
+ * values of the JumpPrime objects of the traced DuelingJP object and the
+ * handles already given out for them, so that a replay can map the handles
+ * of later removeJumper calls to its own.
+ * 2. record stores one operation. It does not lock; concurrent callers
+ * claim separate slots with an atomic counter.
+ * 3. dump writes the initial values, their handles and the recorded
+ * operations to a file.
+ * load reads such a file back.
+ *
+ * ASSUMPTIONS:
+ * 1. A replay only reproduces the traced run if the trace was started on a
+ * DuelingJP object whose JumpPrime objects had not been queried yet;
+ * DuelingJP::startTrace refuses any other object.
+ * 2. dump should not be called while operations are still being recorded.
+ * 3. Trace files use the byte order of the machine that wrote them.
+ */
+
+/// OpTrace is a buffer of binary records of DuelingJP operations.
+class OpTrace {
+
+public:
+
+    /// The DuelingJP operations that can be recorded.
+    enum Operation : unsigned char {
+        CountCollisionsUp, CountCollisionsDown, CountInversions,
+        AddJumper, RemoveJumper, SetDeferredJumps, SettleJumps,
+        ResetAll, ReviveAll
+    };
+
+    /// Record is a single recorded operation.
+    struct Record {
+        /// Microseconds between the start of the trace and the operation.
+        unsigned int timeOffset;
+        /// The argument passed to the operation, if any.
+        int argument;
+        /// The value returned by the operation, if any. Inversion counts
+        /// can exceed the range of an int.
+        long long result;
+        /// The Operation performed.
+        unsigned char operation;
+        unsigned char reserved[7];
+    };
+
+    /// HandleEntry ties a handle of the traced object to its JumpPrime
+    /// objects in the list of initial values.
+    struct HandleEntry {
+        /// The handle, as addJumper returned it.
+        int handle;
+        /// The position in the initial values of the first JumpPrime object
+        /// the handle refers to.
+        int position;
+    };
+
+private:
+
+    /// The buffer of records.
+    std::vector<Record> recordList;
+
+    /// The total number of records claimed, including dropped ones.
+    std::atomic<unsigned long long> recordCount;
+
+    /// The initial values of the JumpPrime objects of the traced object.
+    std::vector<int> initialValues;
+
+    /// The handles in use when the trace started.
+    std::vector<HandleEntry> initialHandles;
+
+    /// When the trace started.
+    std::chrono::steady_clock::time_point startTime;
+
+public:
+
+    /// OpTrace Constructor creates an empty trace.
+    /// @param [in] capacity The number of records kept. Later records are
+    /// dropped.
+    /// @param [in] initValues The initial values of the traced JumpPrime
+    /// objects.
+    /// @param [in] initHandles The handles in use on the traced object.
+    OpTrace(int capacity, const std::vector<int> &initValues,
+            const std::vector<HandleEntry> &initHandles);
+
+    /// record stores one operation in the buffer, or counts it as dropped
+    /// if the buffer is full.
+    /// @param [in] operation The operation performed.
+    /// @param [in] argument The argument passed to the operation.
+    /// @param [in] result The value returned by the operation.
+    void record(Operation operation, int argument, long long result);
+
+    /// getDroppedCount returns how many records did not fit in the buffer.
+    /// @return The number of operations recorded but not stored.
+    unsigned long long getDroppedCount() const;
+
+    /// dump writes the trace to a binary file.
+    /// @param [in] path The path of the file to write.
+    /// @return true if the file was written, false otherwise.
+    bool dump(const char *path) const;
+
+    /// load reads a trace written by dump.
+    /// @param [in] path The path of the file to read.
+    /// @param [out] initValues The initial values of the traced object.
+    /// @param [out] initHandles The handles in use on the traced object.
+    /// @param [out] records The recorded operations, oldest first.
+    /// @param [out] dropped The number of operations that followed the
+    /// records but did not fit in the buffer.
+    /// @return true if the file was read, false otherwise.
+    static bool load(const char *path, std::vector<int> &initValues,
+                     std::vector<HandleEntry> &initHandles,
+                     std::vector<Record> &records,
+                     unsigned long long &dropped);
+
+    /// getOperationName returns a readable name for an operation.
+    /// @param [in] operation The operation.
+    /// @return The name of the operation.
+    static const char *getOperationName(unsigned char operation);
+
+};
+
+
+#endif //INC_5011_P2_OPTRACE_H
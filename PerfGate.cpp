@@ -0,0 +1,599 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include "DuelingJP.h"
+#include "PerfGate.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    /// nanosSince returns the nanoseconds elapsed since a point in time.
+    /// @param [in] start The point in time.
+    /// @return The elapsed nanoseconds.
+    unsigned long long nanosSince(Clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - start).count();
+    }
+
+    /// JsonReader is a minimal reader for the files written by
+    /// PerfGate::writeJson. Every number is stored under its dotted path;
+    /// strings, booleans and nulls are checked for syntax and skipped.
+    struct JsonReader {
+        const std::string &text;
+        size_t position;
+        std::map<std::string, double> &values;
+
+        void skipSpace() {
+            while ((position < text.size()) && std::isspace((unsigned char)text[position])) {
+                position++;
+            }
+        }
+
+        bool readString(std::string &result) {
+            if ((position >= text.size()) || (text[position] != '"')) {
+                return false;
+            }
+            position++;
+            result.clear();
+            while ((position < text.size()) && (text[position] != '"')) {
+                // escapes are kept as written, since names never need them
+                if ((text[position] == '\\') && (position + 1 < text.size())) {
+                    result.push_back(text[position]);
+                    position++;
+                }
+                result.push_back(text[position]);
+                position++;
+            }
+            if (position >= text.size()) {
+                return false;
+            }
+            position++;
+            return true;
+        }
+
+        bool readValue(const std::string &path) {
+            skipSpace();
+            if (position >= text.size()) {
+                return false;
+            }
+
+            char next = text[position];
+            if (next == '{') {
+                position++;
+                skipSpace();
+                if ((position < text.size()) && (text[position] == '}')) {
+                    position++;
+                    return true;
+                }
+                while (true) {
+                    std::string key;
+                    skipSpace();
+                    if (!readString(key)) {
+                        return false;
+                    }
+                    skipSpace();
+                    if ((position >= text.size()) || (text[position] != ':')) {
+                        return false;
+                    }
+                    position++;
+                    if (!readValue(path.empty() ? key : path + "." + key)) {
+                        return false;
+                    }
+                    skipSpace();
+                    if ((position < text.size()) && (text[position] == ',')) {
+                        position++;
+                    } else if ((position < text.size()) && (text[position] == '}')) {
+                        position++;
+                        return true;
+                    } else {
+                        return false;
+                    }
+                }
+            }
+
+            if (next == '[') {
+                position++;
+                skipSpace();
+                if ((position < text.size()) && (text[position] == ']')) {
+                    position++;
+                    return true;
+                }
+                for (int index = 0; ; index++) {
+                    if (!readValue(path + "." + std::to_string(index))) {
+                        return false;
+                    }
+                    skipSpace();
+                    if ((position < text.size()) && (text[position] == ',')) {
+                        position++;
+                    } else if ((position < text.size()) && (text[position] == ']')) {
+                        position++;
+                        return true;
+                    } else {
+                        return false;
+                    }
+                }
+            }
+
+            if (next == '"') {
+                std::string unused;
+                return readString(unused);
+            }
+
+            for (const char *literal : {"true", "false", "null"}) {
+                if (text.compare(position, std::strlen(literal), literal) == 0) {
+                    position = position + std::strlen(literal);
+                    return true;
+                }
+            }
+
+            const char *start = text.c_str() + position;
+            char *end;
+            double number = std::strtod(start, &end);
+            if (end == start) {
+                return false;
+            }
+            position = position + (end - start);
+            values[path] = number;
+            return true;
+        }
+    };
+
+}
+
+
+LatencyHistogram::LatencyHistogram()
+        : bucketCounts(bucketOf(~0ULL) + 1, 0), totalCount(0), maxValue(0) {
+}
+
+int LatencyHistogram::bucketOf(unsigned long long value) {
+
+    // values below 2 * SUB_BUCKET_HALF are counted exactly
+    if (value < 2 * SUB_BUCKET_HALF) {
+        return (int)value;
+    }
+
+    // otherwise keep the top SUB_BUCKET_BITS bits of the value
+    int topBit = 63 - __builtin_clzll(value);
+    int shift = topBit - (SUB_BUCKET_BITS - 1);
+    return shift * SUB_BUCKET_HALF + (int)(value >> shift);
+}
+
+unsigned long long LatencyHistogram::bucketLimit(int bucket) {
+
+    if (bucket < 2 * SUB_BUCKET_HALF) {
+        return bucket;
+    }
+
+    int shift = bucket / SUB_BUCKET_HALF - 1;
+    unsigned long long subBucket = bucket - shift * SUB_BUCKET_HALF;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(unsigned long long nanos) {
+    bucketCounts[bucketOf(nanos)]++;
+    totalCount++;
+    if (nanos > maxValue) {
+        maxValue = nanos;
+    }
+}
+
+unsigned long long LatencyHistogram::percentile(double share) const {
+
+    if (totalCount == 0) {
+        return 0;
+    }
+
+    unsigned long long rank = (unsigned long long)std::ceil(share * totalCount);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    unsigned long long seen = 0;
+    for (size_t bucket = 0; bucket < bucketCounts.size(); bucket++) {
+        seen = seen + bucketCounts[bucket];
+        if (seen >= rank) {
+            unsigned long long limit = bucketLimit((int)bucket);
+            return (limit < maxValue) ? limit : maxValue;
+        }
+    }
+
+    return maxValue;
+}
+
+unsigned long long LatencyHistogram::getCount() const {
+    return totalCount;
+}
+
+unsigned long long LatencyHistogram::getMax() const {
+    return maxValue;
+}
+
+
+const char *PerfGate::getOperationName(int operation) {
+
+    switch (operation) {
+        case Up:
+            return "up";
+        case Down:
+            return "down";
+        case JumpNumber:
+            return "jumpNumber";
+        case CountCollisions:
+            return "countCollisions";
+        case CountInversions:
+            return "countInversions";
+        default:
+            return "unknown";
+    }
+}
+
+void PerfGate::addScenario(const std::string &name, const std::vector<int> &initValues,
+                           int assertedCollisions, int assertedInversions,
+                           int repetitions, int passes) {
+
+    Scenario scenario;
+    scenario.name = name;
+    scenario.initValues = initValues;
+    scenario.assertedCollisions = assertedCollisions;
+    scenario.assertedInversions = assertedInversions;
+    scenario.repetitions = repetitions;
+    scenario.passes = passes;
+    scenarios.push_back(scenario);
+}
+
+void PerfGate::recordBatch(Scenario &scenario, Operation operation,
+                           unsigned long long nanos, int calls) {
+
+    scenario.histograms[operation].record(nanos / calls);
+    scenario.roundHistograms[operation].record(nanos / calls);
+    scenario.callCounts[operation] += calls;
+    scenario.timedNanos[operation] += nanos;
+}
+
+double PerfGate::getThroughput(const Scenario &scenario, int operation) {
+
+    if (scenario.timedNanos[operation] == 0) {
+        return 0;
+    }
+
+    return scenario.callCounts[operation] * 1e9 / scenario.timedNanos[operation];
+}
+
+unsigned long long PerfGate::getLatency(const Scenario &scenario, int operation) {
+
+    std::vector<unsigned long long> latencies = scenario.roundLatencies[operation];
+    if (latencies.empty()) {
+        return 0;
+    }
+
+    std::nth_element(latencies.begin(), latencies.begin() + latencies.size() / 2,
+                     latencies.end());
+    return latencies[latencies.size() / 2];
+}
+
+double PerfGate::getScenarioThroughput(const Scenario &scenario) {
+
+    std::vector<double> throughputs = scenario.roundThroughputs;
+    if (throughputs.empty()) {
+        return 0;
+    }
+
+    std::nth_element(throughputs.begin(), throughputs.begin() + throughputs.size() / 2,
+                     throughputs.end());
+    return throughputs[throughputs.size() / 2];
+}
+
+void PerfGate::runScenario(Scenario &scenario) {
+
+    const int *values = scenario.initValues.data();
+    int size = (int)scenario.initValues.size();
+
+    // small populations are repeated so that a sweep clears the noise floor
+    int copies = (size > 0) ? (MIN_SWEEP_SIZE + size - 1) / size : 0;
+    int sweepSize = copies * size;
+
+    scenario.batchSizes[Up] = sweepSize;
+    scenario.batchSizes[Down] = sweepSize;
+    scenario.batchSizes[JumpNumber] = 1;
+    scenario.batchSizes[CountCollisions] = QUERY_BATCH;
+    scenario.batchSizes[CountInversions] = QUERY_BATCH;
+
+    for (LatencyHistogram &histogram : scenario.roundHistograms) {
+        histogram = LatencyHistogram();
+    }
+    unsigned long long roundOperations = scenario.operationCount;
+
+    Clock::time_point scenarioStart = Clock::now();
+
+    for (int rep = 0; rep < scenario.repetitions; rep++) {
+        DuelingJP collisionJP(values, size);
+        DuelingJP inversionJP(values, size);
+
+        if ((collisionJP.countCollisions() != scenario.assertedCollisions) ||
+            (inversionJP.countInversions() != scenario.assertedInversions)) {
+            scenario.failures++;
+        }
+
+        // later passes include the jumps and revivals the first one does not
+        for (int first = 0; first < scenario.passes; first += QUERY_BATCH) {
+            int last = std::min(first + QUERY_BATCH, scenario.passes);
+
+            Clock::time_point start = Clock::now();
+            for (int pass = first; pass < last; pass++) {
+                collisionJP.countCollisions(pass % 2 == 0);
+            }
+            recordBatch(scenario, CountCollisions, nanosSince(start), last - first);
+
+            start = Clock::now();
+            for (int pass = first; pass < last; pass++) {
+                inversionJP.countInversions();
+            }
+            recordBatch(scenario, CountInversions, nanosSince(start), last - first);
+        }
+
+        scenario.operationCount += 2 * (scenario.passes + 1);
+    }
+
+    // query every JumpPrime object on its own, as a DuelingJP object without
+    // groups would. Sweeps are timed whole; jumps are timed one call at a
+    // time on a separate copy, since only some calls jump. Every copy of a
+    // value jumps on the same pass, so a sweep that included the jumps
+    // would be slow on some passes and fast on the rest.
+    std::vector<JumpPrime> sweepList;
+    std::vector<JumpPrime> jumpList;
+    sweepList.reserve(sweepSize);
+    jumpList.reserve(size);
+    for (int copy = 0; copy < copies; copy++) {
+        for (int i = 0; i < size; i++) {
+            sweepList.emplace_back(values[i]);
+        }
+    }
+    for (int i = 0; i < size; i++) {
+        jumpList.emplace_back(values[i]);
+    }
+
+    std::vector<char> jumps(size);
+
+    for (int pass = 0; (pass < scenario.passes) && (sweepSize > 0); pass++) {
+        bool testUp = (pass % 2 == 0);
+
+        // revivals are not part of up() or down()
+        for (JumpPrime &jumper : sweepList) {
+            if (!jumper.isActive()) {
+                jumper.revive();
+            }
+        }
+        for (JumpPrime &jumper : jumpList) {
+            if (!jumper.isActive()) {
+                jumper.revive();
+            }
+        }
+
+        // the copies are in the same state as jumpList, so a deferred call
+        // on a copy of each shows which calls will jump without a search
+        int sweepCalls = 0;
+        for (int i = 0; i < size; i++) {
+            JumpPrime probe = jumpList[i];
+            if (testUp) {
+                probe.up(true);
+            } else {
+                probe.down(true);
+            }
+            jumps[i] = (probe.getCurrentValue() != jumpList[i].getCurrentValue());
+            sweepCalls += jumps[i] ? 0 : copies;
+        }
+
+        Clock::time_point start = Clock::now();
+        for (int position = 0; position < sweepSize; position += size) {
+            for (int i = 0; i < size; i++) {
+                if (jumps[i]) {
+                    continue;
+                }
+                if (testUp) {
+                    sweepList[position + i].up();
+                } else {
+                    sweepList[position + i].down();
+                }
+            }
+        }
+        unsigned long long elapsed = nanosSince(start);
+        if (sweepCalls > 0) {
+            recordBatch(scenario, testUp ? Up : Down, elapsed, sweepCalls);
+        }
+
+        // the calls left out keep the copies in step with jumpList
+        for (int position = 0; position < sweepSize; position += size) {
+            for (int i = 0; i < size; i++) {
+                if (!jumps[i]) {
+                    continue;
+                }
+                if (testUp) {
+                    sweepList[position + i].up();
+                } else {
+                    sweepList[position + i].down();
+                }
+            }
+        }
+
+        for (JumpPrime &jumper : jumpList) {
+            unsigned int before = jumper.getCurrentValue();
+            start = Clock::now();
+            if (testUp) {
+                jumper.up();
+            } else {
+                jumper.down();
+            }
+            elapsed = nanosSince(start);
+
+            if (jumper.getCurrentValue() != before) {
+                recordBatch(scenario, JumpNumber, elapsed, 1);
+            }
+        }
+
+        scenario.operationCount += sweepList.size() + jumpList.size();
+    }
+
+    double roundSeconds = std::chrono::duration<double>(Clock::now() - scenarioStart).count();
+    scenario.seconds += roundSeconds;
+    if (roundSeconds > 0) {
+        scenario.roundThroughputs.push_back(
+                (scenario.operationCount - roundOperations) / roundSeconds);
+    }
+
+    for (int op = 0; op < OPERATION_COUNT; op++) {
+        if (scenario.roundHistograms[op].getCount() > 0) {
+            scenario.roundLatencies[op].push_back(
+                    scenario.roundHistograms[op].percentile(0.5));
+        }
+    }
+}
+
+bool PerfGate::run() {
+
+    // the scenarios take turns, so a slow stretch of the machine falls on
+    // one round of several scenarios rather than every round of one
+    for (int round = 0; round < ROUNDS; round++) {
+        for (Scenario &scenario : scenarios) {
+            runScenario(scenario);
+        }
+    }
+
+    bool passed = true;
+    for (const Scenario &scenario : scenarios) {
+        passed = passed && (scenario.failures == 0);
+    }
+
+    return passed;
+}
+
+void PerfGate::writeJson(std::ostream &output) const {
+
+    output << "{\n  \"scenarios\": {";
+    for (size_t i = 0; i < scenarios.size(); i++) {
+        const Scenario &scenario = scenarios[i];
+        double throughput = getScenarioThroughput(scenario);
+
+        output << ((i > 0) ? ",\n" : "\n")
+               << "    \"" << scenario.name << "\": {\n"
+               << "      \"population\": " << scenario.initValues.size() << ",\n"
+               << "      \"passed\": " << ((scenario.failures == 0) ? "true" : "false") << ",\n"
+               << "      \"seconds\": " << scenario.seconds << ",\n"
+               << "      \"throughput\": " << throughput << ",\n"
+               << "      \"operations\": {";
+
+        for (int op = 0; op < OPERATION_COUNT; op++) {
+            const LatencyHistogram &histogram = scenario.histograms[op];
+            output << ((op > 0) ? ",\n" : "\n")
+                   << "        \"" << getOperationName(op) << "\": {"
+                   << "\"batch\": " << scenario.batchSizes[op]
+                   << ", \"throughput\": " << getThroughput(scenario, op)
+                   << ", \"count\": " << histogram.getCount()
+                   << ", \"p50\": " << getLatency(scenario, op)
+                   << ", \"p99\": " << histogram.percentile(0.99)
+                   << ", \"p999\": " << histogram.percentile(0.999)
+                   << ", \"max\": " << histogram.getMax() << "}";
+        }
+
+        output << "\n      }\n    }";
+    }
+    output << "\n  }\n}\n";
+}
+
+bool PerfGate::readJson(const std::string &path, std::map<std::string, double> &values) {
+
+    std::ifstream input(path);
+    if (!input) {
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(input)),
+                     std::istreambuf_iterator<char>());
+
+    JsonReader reader{text, 0, values};
+    if (!reader.readValue("")) {
+        return false;
+    }
+    reader.skipSpace();
+
+    return reader.position == text.size();
+}
+
+int PerfGate::compareBaseline(const std::string &path, double tolerance,
+                              std::ostream &report) const {
+
+    std::map<std::string, double> baseline;
+    if (!readJson(path, baseline)) {
+        return -1;
+    }
+
+    int regressions = 0;
+    std::set<std::string> scenariosRun;
+
+    for (const Scenario &scenario : scenarios) {
+        std::string prefix = "scenarios." + scenario.name;
+        scenariosRun.insert(scenario.name);
+
+        auto baseThroughput = baseline.find(prefix + ".throughput");
+        if (baseThroughput == baseline.end()) {
+            report << "No baseline for scenario " << scenario.name << std::endl;
+            continue;
+        }
+
+        double throughput = getScenarioThroughput(scenario);
+        if (throughput * (1 + tolerance) < baseThroughput->second) {
+            report << "REGRESSION " << scenario.name << " throughput: "
+                   << throughput << " calls/s (baseline " << baseThroughput->second
+                   << ")" << std::endl;
+            regressions++;
+        }
+
+        // calls short enough to move with the state of the machine are not
+        // gated, unless they have grown past MIN_GATED_NANOS
+        for (int op = 0; op < OPERATION_COUNT; op++) {
+            auto baseLatency = baseline.find(prefix + ".operations." +
+                                             getOperationName(op) + ".p50");
+            unsigned long long latency = getLatency(scenario, op);
+            if ((baseLatency == baseline.end()) ||
+                ((latency < MIN_GATED_NANOS) &&
+                 (baseLatency->second < MIN_GATED_NANOS))) {
+                continue;
+            }
+
+            if (latency > baseLatency->second * (1 + tolerance)) {
+                report << "REGRESSION " << scenario.name << " "
+                       << getOperationName(op) << " p50: " << latency
+                       << " ns (baseline " << baseLatency->second << " ns)" << std::endl;
+                regressions++;
+            }
+        }
+    }
+
+    // scenarios are found through the population every scenario records
+    const std::string prefix = "scenarios.";
+    const std::string suffix = ".population";
+    for (const auto &entry : baseline) {
+        const std::string &key = entry.first;
+        if ((key.size() <= prefix.size() + suffix.size()) ||
+            (key.compare(0, prefix.size(), prefix) != 0) ||
+            (key.compare(key.size() - suffix.size(), suffix.size(), suffix) != 0)) {
+            continue;
+        }
+
+        std::string name = key.substr(prefix.size(),
+                                      key.size() - prefix.size() - suffix.size());
+        if (scenariosRun.count(name) == 0) {
+            report << "Baseline scenario not run: " << name << std::endl;
+        }
+    }
+
+    return regressions;
+}
@@ -0,0 +1,254 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#ifndef INC_5011_P2_PERFGATE_H
+#define INC_5011_P2_PERFGATE_H
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+/*
+ * The PerfGate runs DuelingJP scenarios while timing every call, checks the
+ * results of each scenario against its asserted counts and compares the
+ * timings with a baseline saved from an earlier run.
+ *
+ * METHODS:
+ * 1. addScenario adds a population and its asserted collision and
+ * inversion counts.
+ * 2. run times the scenarios. Each one counts collisions and inversions on
+ * fresh DuelingJP objects (checking the asserted counts), keeps querying
+ * them for a number of passes, and queries every JumpPrime object of the
+ * population directly with up() and down(). Calls too short to time alone
+ * are timed in batches: the query passes QUERY_BATCH at a time, and up()
+ * and down() one sweep of the population at a time, repeating small
+ * populations to at least MIN_SWEEP_SIZE objects. Each batch is recorded
+ * as its mean latency per call. The calls to up() or down() that make a
+ * JumpPrime object jump are found beforehand on a copy with the search
+ * deferred, left out of the sweep, and timed on their own as jumpNumber
+ * calls.
+ * 3. Every scenario is run ROUNDS times, the rounds of all scenarios
+ * taking turns, and each round has its own p50 latencies and throughput.
+ * The median round is reported and compared, so a stall of the machine
+ * during one round does not move the result.
+ * 4. writeJson writes the results: for every scenario, the median
+ * throughput and, for each operation, its batch size, throughput, the
+ * count, the median p50 and the p99, p999 and max latency of every round
+ * together.
+ * 5. compareBaseline reads a file written by writeJson and reports every
+ * p50 latency, or overall throughput, that is worse than the baseline by
+ * more than a tolerance.
+ *
+ * ASSUMPTIONS:
+ * 1. Latencies are measured in nanoseconds and include the cost of reading
+ * the clock. The histograms keep them to within 2 percent.
+ * 2. An operation whose calls take less than MIN_GATED_NANOS, in both the
+ * baseline and the current run, is not gated. Batching times such calls
+ * well, but calls of a few nanoseconds (up() and down()) or a microsecond
+ * (countCollisions on a handful of groups) speed up or slow down by half
+ * with the state of the caches and of other work on the machine, for
+ * seconds at a time, which no tolerance can tell from a regression. Their
+ * latencies are written for inspection. Neither are the tail latencies: about one
+ * query in a hundred makes a prime search, so p99 and above fall on either
+ * side of that step from run to run. They, and the throughput of each
+ * operation, which a single stall of the machine skews, are written for
+ * inspection only.
+ * 3. Scenarios in the baseline that were not run, and scenarios run that
+ * are not in the baseline, are reported but are not regressions.
+ */
+
+/// LatencyHistogram is a log-linear histogram of latencies in nanoseconds.
+/// Each power of two is split into SUB_BUCKET_HALF linear buckets, so any
+/// value is reported to within 1 / SUB_BUCKET_HALF of itself.
+class LatencyHistogram {
+
+    static const int SUB_BUCKET_BITS = 7;
+    static const int SUB_BUCKET_HALF = 1 << (SUB_BUCKET_BITS - 1);
+
+    /// The number of values in each bucket.
+    std::vector<unsigned long long> bucketCounts;
+
+    /// The number of values recorded.
+    unsigned long long totalCount;
+
+    /// The largest value recorded.
+    unsigned long long maxValue;
+
+    /// bucketOf finds the bucket of a value.
+    /// @param [in] value The value.
+    /// @return The position in bucketCounts.
+    static int bucketOf(unsigned long long value);
+
+    /// bucketLimit returns the largest value in a bucket.
+    /// @param [in] bucket The position in bucketCounts.
+    /// @return The largest value counted in that bucket.
+    static unsigned long long bucketLimit(int bucket);
+
+public:
+
+    /// LatencyHistogram Constructor creates an empty histogram.
+    LatencyHistogram();
+
+    /// record adds a value to the histogram.
+    /// @param [in] nanos The latency in nanoseconds.
+    void record(unsigned long long nanos);
+
+    /// percentile returns the value below which a share of the recorded
+    /// values fall.
+    /// @param [in] share The share, from 0 to 1 (e.g. 0.99 for p99).
+    /// @return The value, or 0 if the histogram is empty.
+    unsigned long long percentile(double share) const;
+
+    /// getCount returns the number of values recorded.
+    /// @return The number of values.
+    unsigned long long getCount() const;
+
+    /// getMax returns the largest value recorded.
+    /// @return The largest value, or 0 if the histogram is empty.
+    unsigned long long getMax() const;
+
+};
+
+/// PerfGate times DuelingJP scenarios and compares them with a baseline.
+class PerfGate {
+
+public:
+
+    /// The operations timed.
+    enum Operation {
+        Up, Down, JumpNumber, CountCollisions, CountInversions, OPERATION_COUNT
+    };
+
+    /// Operations whose p50 latency per call is below this many nanoseconds
+    /// are not gated.
+    static const unsigned long long MIN_GATED_NANOS = 5000;
+
+    /// The number of times every scenario is run.
+    static const int ROUNDS = 5;
+
+private:
+
+    /// The number of query passes timed as one batch.
+    static const int QUERY_BATCH = 8;
+
+    /// The smallest number of JumpPrime objects in a timed sweep of up()
+    /// or down() calls.
+    static const int MIN_SWEEP_SIZE = 256;
+
+    /// Scenario is one population and the results asserted for it.
+    struct Scenario {
+        std::string name;
+        std::vector<int> initValues;
+        int assertedCollisions;
+        int assertedInversions;
+
+        /// How many fresh DuelingJP objects are checked and timed.
+        int repetitions;
+
+        /// How many query passes follow each check.
+        int passes;
+
+        /// Filled in by run. The histograms hold the mean latency per call
+        /// of each batch, over every round and over the current round.
+        LatencyHistogram histograms[OPERATION_COUNT];
+        LatencyHistogram roundHistograms[OPERATION_COUNT];
+
+        /// The p50 latency of each operation, and the throughput, of every
+        /// round.
+        std::vector<unsigned long long> roundLatencies[OPERATION_COUNT];
+        std::vector<double> roundThroughputs;
+
+        int batchSizes[OPERATION_COUNT] = {};
+        unsigned long long callCounts[OPERATION_COUNT] = {};
+        unsigned long long timedNanos[OPERATION_COUNT] = {};
+        unsigned long long operationCount = 0;
+        double seconds = 0;
+        int failures = 0;
+    };
+
+    /// The scenarios, in the order they were added.
+    std::vector<Scenario> scenarios;
+
+    /// runScenario times one round of a scenario.
+    /// @param [in,out] scenario The scenario to run.
+    static void runScenario(Scenario &scenario);
+
+    /// getLatency returns the median of the round p50 latencies of one
+    /// operation.
+    /// @param [in] scenario The scenario that was run.
+    /// @param [in] operation The operation.
+    /// @return The latency in nanoseconds, or 0 if none were timed.
+    static unsigned long long getLatency(const Scenario &scenario, int operation);
+
+    /// getScenarioThroughput returns the median of the round throughputs of
+    /// a scenario.
+    /// @param [in] scenario The scenario that was run.
+    /// @return The calls per second, or 0 if no round was run.
+    static double getScenarioThroughput(const Scenario &scenario);
+
+    /// recordBatch records the time taken by a batch of calls.
+    /// @param [in,out] scenario The scenario the calls belong to.
+    /// @param [in] operation The operation called.
+    /// @param [in] nanos The time taken by the whole batch.
+    /// @param [in] calls The number of calls in the batch.
+    static void recordBatch(Scenario &scenario, Operation operation,
+                            unsigned long long nanos, int calls);
+
+    /// getThroughput returns the calls per second of one operation.
+    /// @param [in] scenario The scenario that was run.
+    /// @param [in] operation The operation.
+    /// @return The calls per second, or 0 if none were timed.
+    static double getThroughput(const Scenario &scenario, int operation);
+
+    /// readJson reads a JSON file into a map of dotted paths to numbers
+    /// (e.g. "scenarios.test0.throughput").
+    /// @param [in] path The file to read.
+    /// @param [out] values Receives every number in the file.
+    /// @return true if the file was read and parsed.
+    static bool readJson(const std::string &path,
+                         std::map<std::string, double> &values);
+
+public:
+
+    /// getOperationName returns a printable name for an operation.
+    /// @param [in] operation The operation.
+    /// @return The name, as used in the JSON output.
+    static const char *getOperationName(int operation);
+
+    /// addScenario adds a scenario to run.
+    /// @param [in] name The name of the scenario, used in the JSON output.
+    /// @param [in] initValues The initial values of the JumpPrime objects.
+    /// @param [in] assertedCollisions The asserted result of
+    /// countCollisions() on a fresh DuelingJP object.
+    /// @param [in] assertedInversions The asserted result of
+    /// countInversions() on a fresh DuelingJP object.
+    /// @param [in] repetitions The number of fresh DuelingJP objects timed.
+    /// @param [in] passes The number of query passes per DuelingJP object.
+    void addScenario(const std::string &name, const std::vector<int> &initValues,
+                     int assertedCollisions, int assertedInversions,
+                     int repetitions, int passes);
+
+    /// run times every scenario.
+    /// @return true if every scenario returned its asserted results.
+    bool run();
+
+    /// writeJson writes the results of run.
+    /// @param [in,out] output The stream to write to.
+    void writeJson(std::ostream &output) const;
+
+    /// compareBaseline compares the results of run with a baseline written
+    /// by writeJson.
+    /// @param [in] path The baseline file.
+    /// @param [in] tolerance The allowed slowdown, as a share (e.g. 0.25).
+    /// @param [in,out] report The stream every regression is reported to.
+    /// @return The number of regressions, or -1 if the baseline could not
+    /// be read.
+    int compareBaseline(const std::string &path, double tolerance,
+                        std::ostream &report) const;
+
+};
+
+
+#endif //INC_5011_P2_PERFGATE_H
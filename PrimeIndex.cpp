@@ -0,0 +1,235 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "PrimeIndex.h"
+
+namespace {
+
+    /// IndexHeader starts every index file. Its size keeps the bitset that
+    /// follows it aligned to 8 bytes.
+    struct IndexHeader {
+        char magic[4];
+        unsigned int version;
+        unsigned int lowLimit;
+        unsigned int highLimit;
+        unsigned long long wordCount;
+    };
+
+    const char INDEX_MAGIC[4] = {'D', 'J', 'P', 'I'};
+    const unsigned int INDEX_VERSION = 1;
+    const int WORD_BITS = 64;
+
+}
+
+
+PrimeIndex::PrimeIndex()
+        : lowLimit(3), highLimit(2), bitWords(nullptr), wordCount(0),
+          mappedRegion(nullptr), mappedSize(0) {
+}
+
+PrimeIndex::PrimeIndex(unsigned int low, unsigned int high)
+        : PrimeIndex() {
+
+    if (low < 3) {
+        low = 3;
+    }
+    if (low % 2 == 0) {
+        low++;
+    }
+    lowLimit = low;
+    highLimit = high;
+
+    if (high < low) {
+        return;
+    }
+
+    // one bit per odd number, all assumed prime until crossed out
+    size_t bitCount = (size_t)(high - low) / 2 + 1;
+    wordCount = (bitCount + WORD_BITS - 1) / WORD_BITS;
+    ownedWords.assign(wordCount, ~0ULL);
+
+    // cross out the odd multiples of every odd number up to sqrt(high)
+    for (unsigned long long factor = 3; factor * factor <= high; factor += 2) {
+
+        unsigned long long multiple = factor * factor;
+        if (multiple < low) {
+            // first odd multiple of factor at or above low
+            multiple = ((low + factor - 1) / factor) * factor;
+            if (multiple % 2 == 0) {
+                multiple += factor;
+            }
+        }
+
+        for (; multiple <= high; multiple += 2 * factor) {
+            size_t bitNumber = (multiple - low) / 2;
+            ownedWords[bitNumber / WORD_BITS] &= ~(1ULL << (bitNumber % WORD_BITS));
+        }
+    }
+
+    // clear the bits past the end of the range
+    size_t extraBits = wordCount * WORD_BITS - bitCount;
+    if (extraBits > 0) {
+        ownedWords[wordCount - 1] &= ~0ULL >> extraBits;
+    }
+
+    bitWords = ownedWords.data();
+}
+
+PrimeIndex::~PrimeIndex() {
+    if (mappedRegion != nullptr) {
+        munmap(mappedRegion, mappedSize);
+    }
+}
+
+std::unique_ptr<PrimeIndex> PrimeIndex::load(const char *path) {
+
+    int fileDescriptor = open(path, O_RDONLY);
+    if (fileDescriptor < 0) {
+        return nullptr;
+    }
+
+    struct stat fileStatus;
+    if ((fstat(fileDescriptor, &fileStatus) != 0) ||
+        ((size_t)fileStatus.st_size < sizeof(IndexHeader))) {
+        close(fileDescriptor);
+        return nullptr;
+    }
+
+    size_t fileSize = fileStatus.st_size;
+    void *region = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED,
+                        fileDescriptor, 0);
+    close(fileDescriptor);
+    if (region == MAP_FAILED) {
+        return nullptr;
+    }
+
+    const IndexHeader *header = (const IndexHeader *)region;
+
+    // the lookups assume an odd lowLimit of at least 3 and a bitset that
+    // covers every odd number up to highLimit, as the constructor builds
+    unsigned long long expectedWords = 0;
+    if (header->highLimit >= header->lowLimit) {
+        unsigned long long bitCount =
+                (unsigned long long)(header->highLimit - header->lowLimit) / 2 + 1;
+        expectedWords = (bitCount + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    if ((std::memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) != 0) ||
+        (header->version != INDEX_VERSION) ||
+        (header->lowLimit < 3) || (header->lowLimit % 2 == 0) ||
+        (header->wordCount != expectedWords) ||
+        (fileSize < sizeof(IndexHeader) +
+                    header->wordCount * sizeof(unsigned long long))) {
+        munmap(region, fileSize);
+        return nullptr;
+    }
+
+    std::unique_ptr<PrimeIndex> index(new PrimeIndex());
+    index->lowLimit = header->lowLimit;
+    index->highLimit = header->highLimit;
+    index->wordCount = header->wordCount;
+    index->bitWords = (const unsigned long long *)(header + 1);
+    index->mappedRegion = region;
+    index->mappedSize = fileSize;
+
+    return index;
+}
+
+bool PrimeIndex::save(const char *path) const {
+
+    std::ofstream indexFile(path, std::ios::binary | std::ios::trunc);
+    if (!indexFile) {
+        return false;
+    }
+
+    IndexHeader header;
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.lowLimit = lowLimit;
+    header.highLimit = highLimit;
+    header.wordCount = wordCount;
+
+    indexFile.write((const char *)&header, sizeof(header));
+    indexFile.write((const char *)bitWords,
+                    wordCount * sizeof(unsigned long long));
+
+    return (bool)indexFile;
+}
+
+bool PrimeIndex::nextPrime(unsigned int value, unsigned int &result) const {
+
+    // the first odd candidate above value
+    unsigned long long candidate = (unsigned long long)value + 1;
+    if (candidate % 2 == 0) {
+        candidate++;
+    }
+    if ((value < lowLimit) || (candidate > highLimit)) {
+        return false;
+    }
+
+    size_t bitNumber = (candidate - lowLimit) / 2;
+    size_t wordNumber = bitNumber / WORD_BITS;
+
+    // ignore the bits below the candidate in its word
+    unsigned long long word = bitWords[wordNumber] &
+                              (~0ULL << (bitNumber % WORD_BITS));
+
+    while (word == 0) {
+        wordNumber++;
+        if (wordNumber >= wordCount) {
+            return false;
+        }
+        word = bitWords[wordNumber];
+    }
+
+    size_t primeBit = wordNumber * WORD_BITS + __builtin_ctzll(word);
+    result = lowLimit + 2 * primeBit;
+
+    return true;
+}
+
+bool PrimeIndex::previousPrime(unsigned int value, unsigned int &result) const {
+
+    // the first odd candidate below value
+    long long candidate = (long long)value - 1;
+    if (candidate % 2 == 0) {
+        candidate--;
+    }
+    if ((value > highLimit) || (candidate < (long long)lowLimit)) {
+        return false;
+    }
+
+    size_t bitNumber = (candidate - lowLimit) / 2;
+    size_t wordNumber = bitNumber / WORD_BITS;
+
+    // ignore the bits above the candidate in its word
+    unsigned long long word = bitWords[wordNumber] &
+                              (~0ULL >> (WORD_BITS - 1 - bitNumber % WORD_BITS));
+
+    while (word == 0) {
+        if (wordNumber == 0) {
+            return false;
+        }
+        wordNumber--;
+        word = bitWords[wordNumber];
+    }
+
+    size_t primeBit = wordNumber * WORD_BITS + (WORD_BITS - 1 - __builtin_clzll(word));
+    result = lowLimit + 2 * primeBit;
+
+    return true;
+}
+
+unsigned int PrimeIndex::getLowLimit() const {
+    return lowLimit;
+}
+
+unsigned int PrimeIndex::getHighLimit() const {
+    return highLimit;
+}
@@ -0,0 +1,104 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#ifndef INC_5011_P2_PRIMEINDEX_H
+#define INC_5011_P2_PRIMEINDEX_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+/*
+ * The PrimeIndex is a precomputed table of the prime numbers within a fixed
+ * range. It stores one bit per odd number in the range, set if the number is
+ * prime. Finding the next or previous prime reads a few 64-bit words at
+ * most, since gaps between primes below 2^32 are at most a few hundred.
+ *
+ * METHODS:
+ * 1. The constructor sieves the given range. This is done once; the result
+ * can be written to a file with save.
+ * 2. load maps a file written by save into memory instead of sieving again.
+ * 3. nextPrime and previousPrime find the nearest prime above or below a
+ * value. They report failure if the answer is not inside the range, so the
+ * caller can fall back to a search.
+ *
+ * ASSUMPTIONS:
+ * 1. The range never includes numbers below 3; 2 is the only even prime and
+ * is left to the caller.
+ * 2. Index files use the byte order of the machine that wrote them.
+ */
+
+/// PrimeIndex is a bitset of the prime numbers within a fixed range.
+class PrimeIndex {
+
+    /// The lowest number covered by the index (always odd).
+    unsigned int lowLimit;
+
+    /// The highest number covered by the index.
+    unsigned int highLimit;
+
+    /// The bitset; bit i is set if lowLimit + 2 * i is prime.
+    const unsigned long long *bitWords;
+
+    /// The number of 64-bit words in the bitset.
+    size_t wordCount;
+
+    /// The bitset, when it was sieved rather than loaded.
+    std::vector<unsigned long long> ownedWords;
+
+    /// The memory-mapped file, when the bitset was loaded.
+    void *mappedRegion;
+    size_t mappedSize;
+
+    /// PrimeIndex Constructor for an empty index, used by load.
+    PrimeIndex();
+
+public:
+
+    /// PrimeIndex Constructor sieves the primes within a range.
+    /// @param [in] low The lowest number to cover. Raised to 3 if lower.
+    /// @param [in] high The highest number to cover.
+    PrimeIndex(unsigned int low, unsigned int high);
+
+    /// PrimeIndex Destructor unmaps a loaded file.
+    ~PrimeIndex();
+
+    PrimeIndex(const PrimeIndex &) = delete;
+    PrimeIndex &operator=(const PrimeIndex &) = delete;
+
+    /// load maps an index file written by save into memory.
+    /// @param [in] path The path of the file to map.
+    /// @return The index, or nullptr if the file could not be mapped or its
+    /// header does not describe a bitset the lookups can use.
+    static std::unique_ptr<PrimeIndex> load(const char *path);
+
+    /// save writes the index to a file that load can map.
+    /// @param [in] path The path of the file to write.
+    /// @return true if the file was written, false otherwise.
+    bool save(const char *path) const;
+
+    /// nextPrime finds the smallest prime number greater than a value.
+    /// @param [in] value The value to search from.
+    /// @param [out] result The prime number found.
+    /// @return true if the prime number is inside the range of the index.
+    bool nextPrime(unsigned int value, unsigned int &result) const;
+
+    /// previousPrime finds the largest prime number less than a value.
+    /// @param [in] value The value to search from.
+    /// @param [out] result The prime number found.
+    /// @return true if the prime number is inside the range of the index.
+    bool previousPrime(unsigned int value, unsigned int &result) const;
+
+    /// getLowLimit returns the lowest number covered by the index.
+    /// @return The lowest number covered.
+    unsigned int getLowLimit() const;
+
+    /// getHighLimit returns the highest number covered by the index.
+    /// @return The highest number covered.
+    unsigned int getHighLimit() const;
+
+};
+
+
+#endif //INC_5011_P2_PRIMEINDEX_H
@@ -0,0 +1,309 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "ShardedDuel.h"
+
+namespace {
+
+    /// The commands a coordinator sends to its workers.
+    const char COMMAND_UP = 'u';
+    const char COMMAND_DOWN = 'd';
+    const char COMMAND_INVERSIONS = 'i';
+
+    /// Distinguishes the segments of ShardedDuel objects in one process.
+    std::atomic<unsigned int> segmentCounter(0);
+
+    /// sendAll writes a buffer to a socket.
+    /// @param [in] channel The socket to write to.
+    /// @param [in] buffer The bytes to write.
+    /// @param [in] size The number of bytes to write.
+    /// @return true if every byte was written.
+    bool sendAll(int channel, const void *buffer, size_t size) {
+
+        const char *bytes = (const char *)buffer;
+        while (size > 0) {
+            // a worker that went away must not raise SIGPIPE
+            ssize_t written = send(channel, bytes, size, MSG_NOSIGNAL);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            bytes = bytes + written;
+            size = size - written;
+        }
+
+        return true;
+    }
+
+    /// readAll reads a buffer from a socket.
+    /// @param [in] channel The socket to read from.
+    /// @param [out] buffer Receives the bytes read.
+    /// @param [in] size The number of bytes to read.
+    /// @return true if every byte was read.
+    bool readAll(int channel, void *buffer, size_t size) {
+
+        char *bytes = (char *)buffer;
+        while (size > 0) {
+            ssize_t readSize = read(channel, bytes, size);
+            if (readSize < 0 && errno == EINTR) {
+                continue;
+            }
+            if (readSize <= 0) {
+                return false;
+            }
+            bytes = bytes + readSize;
+            size = size - readSize;
+        }
+
+        return true;
+    }
+
+    /// shardOf picks the shard for an initial value. The high bits of a
+    /// multiplicative hash spread runs of even or sequential values evenly.
+    /// @param [in] value The initial value.
+    /// @param [in] shardCount The number of shards.
+    /// @return The shard number.
+    int shardOf(int value, int shardCount) {
+        uint32_t hash = (uint32_t)value * 2654435761u;
+        return (int)(((uint64_t)hash * (uint64_t)shardCount) >> 32);
+    }
+
+}
+
+
+ShardedDuel::ShardedDuel(const int initValues[], int size, int shardCount)
+        : populationSize(0), ready(true) {
+
+    if (size < 0) {
+        size = 0;
+    }
+    if (shardCount > size) {
+        shardCount = size;
+    }
+    if (shardCount < 1) {
+        shardCount = 1;
+    }
+
+    std::vector<std::vector<int>> partitions(shardCount);
+    for (int i = 0; i < size; i++) {
+        partitions[shardOf(initValues[i], shardCount)].push_back(initValues[i]);
+    }
+    populationSize = size;
+
+    shards.resize(shardCount);
+    for (int i = 0; i < shardCount; i++) {
+        if (!startShard(shards[i], i, partitions[i])) {
+            ready = false;
+        }
+    }
+}
+
+ShardedDuel::~ShardedDuel() {
+
+    // a closed channel tells the worker to exit
+    for (Shard &shard : shards) {
+        if (shard.channel >= 0) {
+            close(shard.channel);
+        }
+    }
+
+    for (Shard &shard : shards) {
+        if (shard.worker > 0) {
+            while ((waitpid(shard.worker, nullptr, 0) < 0) && (errno == EINTR)) {
+            }
+        }
+        if (shard.values != nullptr) {
+            munmap(shard.values, 2 * shard.capacity * sizeof(ValueCount));
+        }
+    }
+}
+
+bool ShardedDuel::startShard(Shard &shard, int shardNumber,
+                             const std::vector<int> &initValues) {
+
+    // identical initial values share a group and the members of a group
+    // never diverge, so a shard never publishes more values than it has
+    // distinct initial values
+    std::vector<int> distinctValues(initValues);
+    std::sort(distinctValues.begin(), distinctValues.end());
+    size_t distinctCount = std::unique(distinctValues.begin(), distinctValues.end()) -
+                           distinctValues.begin();
+    shard.capacity = (distinctCount == 0) ? 1 : distinctCount;
+    size_t mapSize = 2 * shard.capacity * sizeof(ValueCount);
+
+    std::string segmentName = "/duelingjp-" + std::to_string(getpid()) + "-" +
+                              std::to_string(segmentCounter.fetch_add(1)) + "-" +
+                              std::to_string(shardNumber);
+    int segment = shm_open(segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (segment < 0) {
+        return false;
+    }
+
+    void *mapping = MAP_FAILED;
+    if (ftruncate(segment, (off_t)mapSize) == 0) {
+        mapping = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       segment, 0);
+    }
+
+    // the mapping stays valid in this process and, after fork, the worker
+    close(segment);
+    shm_unlink(segmentName.c_str());
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    shard.values = (ValueCount *)mapping;
+
+    int channels[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, channels) != 0) {
+        return false;
+    }
+
+    shard.worker = fork();
+    if (shard.worker < 0) {
+        close(channels[0]);
+        close(channels[1]);
+        return false;
+    }
+
+    if (shard.worker == 0) {
+        // the worker must not hold the channels of earlier shards open, or
+        // those workers would never see their channel close
+        for (int i = 0; i < shardNumber; i++) {
+            if (shards[i].channel >= 0) {
+                close(shards[i].channel);
+            }
+        }
+        close(channels[0]);
+        runWorker(channels[1], shard.values, shard.capacity, initValues);
+    }
+
+    close(channels[1]);
+    shard.channel = channels[0];
+
+    return true;
+}
+
+void ShardedDuel::runWorker(int channel, ValueCount *values, size_t capacity,
+                            const std::vector<int> &initValues) {
+
+    DuelingJP shardJP(initValues.data(), (int)initValues.size());
+
+    std::vector<ValueCount> upValues;
+    std::vector<ValueCount> downValues;
+
+    char command;
+    while (readAll(channel, &command, sizeof(command))) {
+        upValues.clear();
+        downValues.clear();
+
+        if (command == COMMAND_INVERSIONS) {
+            shardJP.queryInversionValues(upValues, downValues);
+            DuelingJP::sortValues(downValues);
+        } else {
+            shardJP.queryValues(command == COMMAND_UP, upValues);
+        }
+        DuelingJP::sortValues(upValues);
+
+        // more values than the segment holds would overrun it; closing the
+        // channel reports the failure instead
+        if ((upValues.size() > capacity) || (downValues.size() > capacity)) {
+            break;
+        }
+
+        std::copy(upValues.begin(), upValues.end(), values);
+        std::copy(downValues.begin(), downValues.end(), values + capacity);
+
+        // the reply follows the values, so the coordinator sees them filled
+        uint32_t counts[2] = {(uint32_t)upValues.size(), (uint32_t)downValues.size()};
+        if (!sendAll(channel, counts, sizeof(counts))) {
+            break;
+        }
+    }
+
+    close(channel);
+    _exit(0);
+}
+
+bool ShardedDuel::runQuery(char command, std::vector<ValueCount> &upValues,
+                           std::vector<ValueCount> &downValues) {
+
+    if (!ready) {
+        return false;
+    }
+
+    // start every worker before waiting on any of them
+    for (Shard &shard : shards) {
+        if (!sendAll(shard.channel, &command, sizeof(command))) {
+            ready = false;
+        }
+    }
+
+    for (Shard &shard : shards) {
+        uint32_t counts[2];
+        if ((!ready) || !readAll(shard.channel, counts, sizeof(counts)) ||
+            (counts[0] > shard.capacity) || (counts[1] > shard.capacity)) {
+            ready = false;
+            continue;
+        }
+
+        upValues.insert(upValues.end(), shard.values, shard.values + counts[0]);
+        downValues.insert(downValues.end(), shard.values + shard.capacity,
+                          shard.values + shard.capacity + counts[1]);
+    }
+
+    if (!ready) {
+        return false;
+    }
+
+    // the same value may come from several shards
+    DuelingJP::sortValues(upValues);
+    DuelingJP::sortValues(downValues);
+
+    return true;
+}
+
+long long ShardedDuel::countCollisions(bool testUp) {
+
+    std::vector<ValueCount> values;
+    std::vector<ValueCount> unused;
+    if (!runQuery(testUp ? COMMAND_UP : COMMAND_DOWN, values, unused)) {
+        return -1;
+    }
+
+    return DuelingJP::tallyCollisions(values);
+}
+
+long long ShardedDuel::countInversions() {
+
+    std::vector<ValueCount> upValues;
+    std::vector<ValueCount> downValues;
+    if (!runQuery(COMMAND_INVERSIONS, upValues, downValues)) {
+        return -1;
+    }
+
+    return DuelingJP::tallyInversions(upValues, downValues);
+}
+
+bool ShardedDuel::isReady() const {
+    return ready;
+}
+
+int ShardedDuel::getSize() const {
+    return populationSize;
+}
+
+int ShardedDuel::getShardCount() const {
+    return (int)shards.size();
+}
@@ -0,0 +1,133 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#ifndef INC_5011_P2_SHARDEDDUEL_H
+#define INC_5011_P2_SHARDEDDUEL_H
+
+#include <sys/types.h>
+#include <vector>
+#include "DuelingJP.h"
+
+
+/*
+ * The ShardedDuel spreads one population of JumpPrime objects across several
+ * worker processes, each holding its share in a DuelingJP object of its own,
+ * so a population can use the memory and cores of more than one process.
+ * After each query every worker publishes the values its JumpPrime objects
+ * returned into a POSIX shared memory segment, and the coordinating process
+ * merges them into the exact counts for the whole population.
+ *
+ * METHODS:
+ * 1. The constructor accepts an array of initial values, the number of
+ * values and the number of shards, and starts one worker process per shard.
+ * Values are assigned to shards by initial value, so identical JumpPrime
+ * objects share a shard and are stored once.
+ * 2. countCollisions and countInversions return the same counts as a single
+ * DuelingJP object built from the same values and given the same queries.
+ * The workers run each query at the same time.
+ * 3. The destructor stops the workers and releases the shared memory.
+ *
+ * ASSUMPTIONS:
+ * 1. Worker processes are created with fork, so the ShardedDuel should be
+ * built before the program starts any threads of its own.
+ * 2. Each shared memory segment is removed from the namespace as soon as it
+ * is mapped, so no segment outlives the processes using it.
+ * 3. If a worker cannot be started or stops unexpectedly, isReady returns
+ * false and the queries return -1.
+ */
+
+/// ShardedDuel counts collisions and inversions across worker processes.
+class ShardedDuel {
+
+    using ValueCount = DuelingJP::ValueCount;
+
+    /// Shard holds the coordinator's side of one worker process.
+    struct Shard {
+        /// The worker's process id.
+        pid_t worker = -1;
+        /// The coordinator's end of the socket pair shared with the worker.
+        int channel = -1;
+        /// The shared memory values: capacity up() entries, then capacity
+        /// down() entries.
+        ValueCount *values = nullptr;
+        /// The number of entries in each half of values: one per distinct
+        /// initial value in the shard.
+        size_t capacity = 0;
+    };
+
+    /// The shards, one per worker process.
+    std::vector<Shard> shards;
+
+    /// The total number of JumpPrime objects across all shards.
+    int populationSize;
+
+    /// False once any worker could not be started or reached.
+    bool ready;
+
+    /// startShard maps a shard's shared memory and starts its worker.
+    /// @param [in,out] shard The shard to start.
+    /// @param [in] shardNumber The position of the shard, for naming.
+    /// @param [in] initValues The initial values of the shard.
+    /// @return true if the worker was started.
+    bool startShard(Shard &shard, int shardNumber,
+                    const std::vector<int> &initValues);
+
+    /// runWorker answers commands from the coordinator until the channel is
+    /// closed. It runs in the worker process and never returns.
+    /// @param [in] channel The worker's end of the socket pair.
+    /// @param [in] values The shard's shared memory values.
+    /// @param [in] capacity The number of entries in each half of values.
+    /// @param [in] initValues The initial values of the shard.
+    [[noreturn]] static void runWorker(int channel, ValueCount *values,
+                                       size_t capacity,
+                                       const std::vector<int> &initValues);
+
+    /// runQuery sends a command to every worker and merges the values they
+    /// publish.
+    /// @param [in] command The command to send.
+    /// @param [out] upValues The merged up() values (or the only values, for
+    /// a collision query).
+    /// @param [out] downValues The merged down() values of an inversion query.
+    /// @return true if every worker answered.
+    bool runQuery(char command, std::vector<ValueCount> &upValues,
+                  std::vector<ValueCount> &downValues);
+
+public:
+
+    /// ShardedDuel Constructor starts the worker processes.
+    /// @param [in] initValues Array of initial values for JumpPrime objects.
+    /// @param [in] size The number of items in initValues.
+    /// @param [in] shardCount The number of worker processes.
+    ShardedDuel(const int initValues[], int size, int shardCount);
+
+    /// ShardedDuel Destructor stops the worker processes.
+    ~ShardedDuel();
+
+    ShardedDuel(const ShardedDuel &) = delete;
+    ShardedDuel &operator=(const ShardedDuel &) = delete;
+
+    /// countCollisions counts collisions across every shard.
+    /// @param [in] testUp If true, tests up(), otherwise tests down().
+    /// @return The number of collisions, or -1 if a worker failed.
+    long long countCollisions(bool testUp = true);
+
+    /// countInversions counts inversions across every shard.
+    /// @return The number of inversions, or -1 if a worker failed.
+    long long countInversions();
+
+    /// isReady returns whether every worker is running.
+    /// @return true if queries can be answered.
+    bool isReady() const;
+
+    /// getSize returns the number of JumpPrime objects across all shards.
+    /// @return The population size.
+    int getSize() const;
+
+    /// getShardCount returns the number of worker processes.
+    /// @return The number of shards.
+    int getShardCount() const;
+
+};
+
+
+#endif //INC_5011_P2_SHARDEDDUEL_H
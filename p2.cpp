@@ -2,11 +2,24 @@
 // Date: 02/07/2023
 // Revision: 1.0
 
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <vector>
 #include <stack>
+#include <string>
+#include <thread>
 #include "DuelingJP.h"
+#include "OpTrace.h"
+#include "BatchEvaluator.h"
+#include "PrimeIndex.h"
+#include "DuelServer.h"
+#include "DuelClient.h"
+#include "ShardedDuel.h"
+#include "PerfGate.h"
 
 using std::cout;
 using std::cin;
@@ -213,7 +226,575 @@ void moveVectorTest() {
 
 }
 
-int main() {
+/// membershipTest grows a DuelingJP object one JumpPrime at a time and then
+/// removes JumpPrime objects to test addJumper and removeJumper.
+void membershipTest() {
+
+    cout << endl << endl;
+
+    cout << "Testing DuelingJP membership changes" << endl;
+    cout << "** ** ** ** ** ** ** ** **" << endl;
+
+    DuelingJP testJP(TEST_ARRAYS[1], 0);
+    int handles[TEST_SIZE];
+    for (int i = 0; i < TEST_SIZE; i++) {
+        handles[i] = testJP.addJumper(TEST_ARRAYS[1][i]);
+    }
+    cout << "testJP has size " << testJP.getSize() << " and "
+         << testJP.countCollisions() << " collisions." << endl;
+    cout << "Asserted test results: " << COLLISION_RESULTS[1] << endl;
+    cout << "testJP stores " << testJP.getDistinctSize()
+         << " distinct JumpPrime objects." << endl;
+
+    testJP.removeJumper(handles[0]);
+    testJP.removeJumper(handles[TEST_SIZE - 1]);
+    cout << "After removing two, testJP has size " << testJP.getSize()
+         << " and " << testJP.countCollisions() << " collisions." << endl;
+    cout << "Asserted test results: " << COLLISION_RESULTS[1] - 2 << endl;
+
+}
+
+/// deferredJumpTest runs the same queries on two copies of a DuelingJP
+/// object, one with deferred jumps, to test that both give the same results.
+void deferredJumpTest() {
+
+    cout << endl << endl;
+
+    cout << "Testing DuelingJP deferred jumps" << endl;
+    cout << "** ** ** ** ** ** ** ** **" << endl;
+
+    DuelingJP eagerJP(TEST_ARRAYS[0], TEST_SIZE);
+    DuelingJP deferredJP(eagerJP);
+    deferredJP.setDeferredJumps(true);
+
+    // settles a few deferred jumps at the start of every query instead
+    DuelingJP boundedJP(eagerJP);
+    boundedJP.setDeferredJumps(true, 2);
+
+    int mismatches = 0;
+    int settled = 0;
+    for (int i = 0; i < 30; i++) {
+        int collisions = eagerJP.countCollisions(i % 2 == 0);
+        if ((collisions != deferredJP.countCollisions(i % 2 == 0)) ||
+            (collisions != boundedJP.countCollisions(i % 2 == 0))) {
+            mismatches++;
+        }
+        long long inversions = eagerJP.countInversions();
+        if ((inversions != deferredJP.countInversions()) ||
+            (inversions != boundedJP.countInversions())) {
+            mismatches++;
+        }
+
+        // spread the deferred work out, one jump at a time
+        settled = settled + deferredJP.settleJumps(1);
+    }
+
+    cout << "Settled " << settled << " deferred jumps between queries." << endl;
+    cout << "Eager and deferred results differed " << mismatches
+         << " times." << endl;
+    cout << "Asserted test results: 0" << endl;
+
+}
+
+/// traceTest records the operations on a DuelingJP object and writes the
+/// trace to disk so that it can be replayed with jp_replay.
+void traceTest() {
+
+    cout << endl << endl;
+
+    cout << "Testing DuelingJP operation trace" << endl;
+    cout << "** ** ** ** ** ** ** ** **" << endl;
+
+    DuelingJP testJP(TEST_ARRAYS[0], TEST_SIZE);
+    testJP.startTrace(64);
+    testJP.countCollisions();
+    testJP.countInversions();
+    testJP.addJumper(TEST_ARRAYS[2][0]);
+    testJP.countCollisions(false);
+
+    if (testJP.dumpTrace("p2_trace.bin")) {
+        cout << "Trace written to p2_trace.bin." << endl;
+    } else {
+        cout << "Trace could not be written." << endl;
+    }
+
+    // a queried object could not be replayed from its initial values
+    cout << "Trace started on a queried object: "
+         << (testJP.startTrace(64) ? "yes" : "no") << endl;
+    cout << "Asserted test results: no" << endl;
+
+    // a trace cut short after its header claims more than the file holds
+    {
+        std::ifstream traceFile("p2_trace.bin", std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(traceFile)),
+                             std::istreambuf_iterator<char>());
+        std::ofstream shortFile("p2_short_trace.bin", std::ios::binary | std::ios::trunc);
+        shortFile << contents.substr(0, contents.size() / 2);
+    }
+    std::vector<int> initValues;
+    std::vector<OpTrace::HandleEntry> initHandles;
+    std::vector<OpTrace::Record> records;
+    unsigned long long dropped = 0;
+    cout << "Truncated trace loaded: "
+         << (OpTrace::load("p2_short_trace.bin", initValues, initHandles,
+                           records, dropped) ? "yes" : "no") << endl;
+    cout << "Asserted test results: no" << endl;
+    std::remove("p2_short_trace.bin");
+
+}
+
+/// peekTest compares the non-mutating peek queries of a DuelingJP object
+/// with the asserted results, then checks that the object was not changed.
+void peekTest() {
+
+    cout << endl << endl;
+
+    cout << "Testing DuelingJP peek queries" << endl;
+    cout << "** ** ** ** ** ** ** ** **" << endl;
+
+    for (int i = 0; i < TEST_COUNT; i++) {
+        const DuelingJP testJP(TEST_ARRAYS[i], TEST_SIZE);
+        cout << "Test #" << i << ": peekCollisions gives "
+             << testJP.peekCollisions() << " (asserted "
+             << COLLISION_RESULTS[i] << "), peekInversions gives "
+             << testJP.peekInversions() << " (asserted "
+             << INVERSION_RESULTS[i] << ")" << endl;
+    }
+
+    DuelingJP testJP(TEST_ARRAYS[0], TEST_SIZE);
+    DuelingJP untouchedJP(testJP);
+    for (int i = 0; i < 50; i++) {
+        testJP.peekCollisions(i % 2 == 0);
+        testJP.peekInversions();
+    }
+    cout << "After 50 peeks, countCollisions gives " << testJP.countCollisions()
+         << " and an untouched copy gives " << untouchedJP.countCollisions()
+         << "." << endl;
+
+}
+
+/// batchTest evaluates a vector of heap-allocated DuelingJP objects on a
+/// thread pool and compares the results with the asserted results.
+void batchTest() {
+
+    cout << endl << endl;
+
+    cout << "Testing DuelingJP batch evaluation" << endl;
+    cout << "** ** ** ** ** ** ** ** **" << endl;
+
+    std::vector<std::unique_ptr<DuelingJP>> duelList;
+    for (int i = 0; i < TEST_COUNT; i++) {
+        duelList.push_back(std::make_unique<DuelingJP>(TEST_ARRAYS[i], TEST_SIZE));
+    }
+
+    // a small split size forces the larger DuelingJP objects to be split
+    BatchEvaluator evaluator(4, 2);
+    std::vector<DuelResult> results = evaluator.evaluate(duelList);
+
+    for (int i = 0; i < (int)results.size(); i++) {
+        cout << "Element " << i << " has " << results[i].upCollisions
+             << " collisions (asserted " << COLLISION_RESULTS[i] << ") and "
+             << results[i].inversions << " inversions (asserted "
+             << INVERSION_RESULTS[i] << ")" << endl;
+    }
+
+    // a stack is evaluated from the bottom up, so it matches the list
+    std::stack<const DuelingJP *> duelStack;
+    for (const auto &duel : duelList) {
+        duelStack.push(duel.get());
+    }
+    std::vector<DuelResult> stackResults = evaluator.evaluate(duelStack);
+
+    int stackMismatches = (stackResults.size() == results.size()) ? 0 : 1;
+    for (int i = 0; (stackMismatches == 0) && (i < (int)results.size()); i++) {
+        if ((stackResults[i].upCollisions != results[i].upCollisions) ||
+            (stackResults[i].downCollisions != results[i].downCollisions) ||
+            (stackResults[i].inversions != results[i].inversions)) {
+            stackMismatches++;
+        }
+    }
+    cout << "Stack and list results differed " << stackMismatches
+         << " times." << endl;
+    cout << "Asserted test results: 0" << endl;
+
+}
+
+/// joinTest joins two DuelingJP objects and compares the result with a
+/// DuelingJP object holding both populations, less each population's own
+/// counts.
+void joinTest() {
+
+    cout << endl << endl;
+
+    cout << "Testing DuelingJP join" << endl;
+    cout << "** ** ** ** ** ** ** ** **" << endl;
+
+    DuelingJP firstJP(TEST_ARRAYS[0], TEST_SIZE);
+    DuelingJP secondJP(TEST_ARRAYS[0], TEST_SIZE);
+    DuelingJP bothJP(TEST_ARRAYS[0], TEST_SIZE);
+    for (int i = 0; i < TEST_SIZE; i++) {
+        bothJP.addJumper(TEST_ARRAYS[0][i]);
+    }
+
+    JoinResult result = firstJP.join(secondJP);
+
+    cout << "Join has " << result.upCollisions << " collisions (asserted "
+         << bothJP.peekCollisions() - firstJP.peekCollisions()
+            - secondJP.peekCollisions()
+         << ") and " << result.inversions << " inversions (asserted "
+         << bothJP.peekInversions() - firstJP.peekInversions()
+            - secondJP.peekInversions()
+         << ")" << endl;
+
+    // the sorted values kept from the first join must not outlive a change
+    for (int i = 0; i < 25; i++) {
+        firstJP.countCollisions(i % 2 == 0);
+        secondJP.countCollisions(i % 2 == 0);
+        bothJP.countCollisions(i % 2 == 0);
+    }
+    result = firstJP.join(secondJP);
+
+    cout << "After queries, join has " << result.downCollisions
+         << " down collisions (asserted "
+         << bothJP.peekCollisions(false) - firstJP.peekCollisions(false)
+            - secondJP.peekCollisions(false)
+         << ") and " << result.inversions << " inversions (asserted "
+         << bothJP.peekInversions() - firstJP.peekInversions()
+            - secondJP.peekInversions()
+         << ")" << endl;
+
+}
+
+/// primeIndexTest saves a table of primes to disk, maps it back into memory
+/// and reruns the collision and inversion tests with nearest primes looked
+/// up in the table.
+void primeIndexTest() {
+
+    cout << endl << endl;
+
+    cout << "Testing DuelingJP with a prime index" << endl;
+    cout << "** ** ** ** ** ** ** ** **" << endl;
+
+    {
+        PrimeIndex builtIndex(1000, 1000000);
+        builtIndex.save("p2_primes.idx");
+    }
+
+    std::unique_ptr<PrimeIndex> loadedIndex = PrimeIndex::load("p2_primes.idx");
+    if (loadedIndex == nullptr) {
+        cout << "Prime index could not be loaded." << endl;
+        return;
+    }
+    cout << "Loaded prime index over [" << loadedIndex->getLowLimit() << ", "
+         << loadedIndex->getHighLimit() << "]" << endl;
+
+    JumpPrime::setPrimeIndex(loadedIndex.get());
+    for (int i = 0; i < TEST_COUNT; i++) {
+        DuelingJP testJP(TEST_ARRAYS[i], TEST_SIZE);
+        cout << "Test #" << i << ": " << testJP.countCollisions()
+             << " collisions (asserted " << COLLISION_RESULTS[i] << ")" << endl;
+        DuelingJP inversionJP(TEST_ARRAYS[i], TEST_SIZE);
+        cout << "Test #" << i << ": " << inversionJP.countInversions()
+             << " inversions (asserted " << INVERSION_RESULTS[i] << ")" << endl;
+    }
+    JumpPrime::setPrimeIndex(nullptr);
+
+    // an even lowLimit would misplace every lookup, so load must refuse it
+    {
+        std::ifstream goodFile("p2_primes.idx", std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(goodFile)),
+                             std::istreambuf_iterator<char>());
+        unsigned int evenLimit = 1000;
+        contents.replace(8, sizeof(evenLimit), (const char *)&evenLimit,
+                         sizeof(evenLimit));
+        std::ofstream badFile("p2_bad_primes.idx", std::ios::binary | std::ios::trunc);
+        badFile << contents;
+    }
+    cout << "Index with an even low limit loaded: "
+         << ((PrimeIndex::load("p2_bad_primes.idx") != nullptr) ? "yes" : "no")
+         << endl;
+    cout << "Asserted test results: no" << endl;
+    std::remove("p2_bad_primes.idx");
+
+}
+
+/// serverTest runs a DuelServer on a separate thread and sends it a batch of
+/// pipelined requests, comparing the answers with the asserted results.
+void serverTest() {
+
+    cout << endl << endl;
+
+    cout << "Testing DuelingJP server" << endl;
+    cout << "** ** ** ** ** ** ** ** **" << endl;
+
+    const std::string socketPath = "p2_duel.sock";
+    DuelServer server(socketPath);
+    std::thread serverThread(&DuelServer::serve, &server);
+
+    // wait for the server to start listening
+    std::unique_ptr<DuelClient> client;
+    for (int attempt = 0; attempt < 50; attempt++) {
+        client = std::make_unique<DuelClient>(socketPath);
+        if (client->isConnected()) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    if (!client->isConnected()) {
+        cout << "Could not connect to the server." << endl;
+    } else {
+        // send every request before reading any response
+        for (int i = 0; i < TEST_COUNT; i++) {
+            std::string name = "test" + std::to_string(i);
+            client->sendRequest(DuelProtocol::Create, name + "c", 0, true,
+                                TEST_ARRAYS[i], TEST_SIZE);
+            client->sendRequest(DuelProtocol::Create, name + "i", 0, true,
+                                TEST_ARRAYS[i], TEST_SIZE);
+            client->sendRequest(DuelProtocol::CountCollisions, name + "c");
+            client->sendRequest(DuelProtocol::CountInversions, name + "i");
+        }
+
+        for (int i = 0; i < TEST_COUNT; i++) {
+            DuelProtocol::ResponseHeader response[4];
+            for (int r = 0; r < 4; r++) {
+                client->readResponse(response[r]);
+            }
+            cout << "Test #" << i << ": server reports " << response[2].result
+                 << " collisions (asserted " << COLLISION_RESULTS[i] << ") and "
+                 << response[3].result << " inversions (asserted "
+                 << INVERSION_RESULTS[i] << ")" << endl;
+        }
+
+        // a Step too long to run on the serving thread is refused
+        client->sendRequest(DuelProtocol::Step, "test0c",
+                            DuelProtocol::MAX_STEP_PASSES + 1, true);
+        DuelProtocol::ResponseHeader response;
+        client->readResponse(response);
+        cout << "Step over the pass limit refused: "
+             << ((response.status == DuelProtocol::BadRequest) ? "yes" : "no")
+             << endl;
+        cout << "Asserted test results: yes" << endl;
+    }
+
+    client.reset();
+    server.stop();
+    serverThread.join();
+
+    // a file that is not a socket must be left alone
+    const std::string filePath = "p2_not_a_socket";
+    std::ofstream(filePath) << "keep" << endl;
+    DuelServer fileServer(filePath);
+    bool served = fileServer.serve();
+    cout << "Server started over a regular file: " << (served ? "yes" : "no")
+         << "; file kept: " << (std::ifstream(filePath) ? "yes" : "no") << endl;
+    cout << "Asserted test results: no; yes" << endl;
+    std::remove(filePath.c_str());
+
+}
+
+/// shardedTest spreads each test population across worker processes and
+/// compares the merged counts with the asserted results and with a single
+/// DuelingJP object given the same queries.
+void shardedTest() {
+
+    cout << endl << endl;
+
+    cout << "Testing sharded DuelingJP" << endl;
+    cout << "** ** ** ** ** ** ** ** **" << endl;
+
+    for (int i = 0; i < TEST_COUNT; i++) {
+        ShardedDuel collisionDuel(TEST_ARRAYS[i], TEST_SIZE, 2);
+        ShardedDuel inversionDuel(TEST_ARRAYS[i], TEST_SIZE, 2);
+        cout << "Test #" << i << ": " << collisionDuel.countCollisions()
+             << " collisions (asserted " << COLLISION_RESULTS[i] << ") and "
+             << inversionDuel.countInversions() << " inversions (asserted "
+             << INVERSION_RESULTS[i] << ")" << endl;
+    }
+
+    const int largeSize = 2000;
+    std::vector<int> largeValues(largeSize);
+    for (int i = 0; i < largeSize; i++) {
+        largeValues[i] = 1000 + (i * 37) % 700;
+    }
+
+    ShardedDuel shardedJP(largeValues.data(), largeSize, 4);
+    DuelingJP singleJP(largeValues.data(), largeSize);
+
+    int mismatches = 0;
+    for (int pass = 0; pass < 12; pass++) {
+        if (pass % 3 == 2) {
+            mismatches += (shardedJP.countInversions() != singleJP.countInversions());
+        } else {
+            bool testUp = (pass % 3 == 0);
+            mismatches += (shardedJP.countCollisions(testUp) !=
+                           singleJP.countCollisions(testUp));
+        }
+    }
+
+    cout << "A population of " << shardedJP.getSize() << " across "
+         << shardedJP.getShardCount() << " shards had " << mismatches
+         << " mismatched counts (asserted 0)" << endl;
+
+    // every up() of 1000 gives 1009, as does every down() of 1010, so the
+    // count is 50000 * 50000, beyond the range of an int
+    const int pairedSize = 100000;
+    std::vector<int> pairedValues(pairedSize);
+    for (int i = 0; i < pairedSize; i++) {
+        pairedValues[i] = (i % 2 == 0) ? 1000 : 1010;
+    }
+    ShardedDuel pairedJP(pairedValues.data(), pairedSize, 2);
+    cout << "A population of " << pairedJP.getSize() << " has "
+         << pairedJP.countInversions() << " inversions (asserted 2500000000)"
+         << endl;
+
+    // a single DuelingJP object reports the same count without sharding
+    DuelingJP singlePairedJP(pairedValues.data(), pairedSize);
+    cout << "A single object of " << singlePairedJP.getSize() << " peeks "
+         << singlePairedJP.peekInversions() << " and counts "
+         << singlePairedJP.countInversions()
+         << " inversions (asserted 2500000000)" << endl;
+
+}
+
+/// bulkResetTest resets and revives whole DuelingJP objects at once. After
+/// resetAll the counts match the asserted results again, and reviving
+/// between passes gives the same counts as reviving during them.
+void bulkResetTest() {
+
+    cout << endl << endl;
+
+    cout << "Testing DuelingJP resetAll and reviveAll" << endl;
+    cout << "** ** ** ** ** ** ** ** **" << endl;
+
+    for (int i = 0; i < TEST_COUNT; i++) {
+        DuelingJP testJP(TEST_ARRAYS[i], TEST_SIZE);
+        for (int pass = 0; pass < 20; pass++) {
+            testJP.countCollisions(pass % 2 == 0);
+        }
+
+        // the added JumpPrime objects differ from the queried ones until
+        // they are all reset
+        for (int j = 0; j < TEST_SIZE; j++) {
+            testJP.addJumper(TEST_ARRAYS[i][j]);
+        }
+        int distinctBefore = testJP.getDistinctSize();
+        int resetCount = testJP.resetAll();
+
+        cout << "Test #" << i << ": reset " << resetCount << " of "
+             << testJP.getSize() << ", " << distinctBefore << " groups became "
+             << testJP.getDistinctSize() << ", " << testJP.countInversions()
+             << " inversions (asserted " << INVERSION_RESULTS[i] * 4 << ")"
+             << endl;
+    }
+
+    DuelingJP revivedJP(TEST_ARRAYS[0], TEST_SIZE);
+    DuelingJP lazyJP(TEST_ARRAYS[0], TEST_SIZE);
+    revivedJP.setDeferredJumps(true);
+
+    int revived = 0;
+    int mismatches = 0;
+    for (int pass = 0; pass < 200; pass++) {
+        mismatches += (revivedJP.countCollisions() != lazyJP.countCollisions());
+        revived += revivedJP.reviveAll();
+    }
+
+    cout << "Revived " << revived << " JumpPrime objects with " << mismatches
+         << " mismatched counts (asserted 0)" << endl;
+
+}
+
+/// perfMode times the test scenarios, and copies of them scaled up, with a
+/// PerfGate, writes the latencies as JSON and compares them with a baseline.
+/// Usage: --perf [--baseline file] [--tolerance share] [--output file]
+/// @param [in] argc The number of arguments after --perf.
+/// @param [in] argv The arguments after --perf.
+/// @return 0 if every result was as asserted and nothing regressed, 1 if a
+/// result was wrong or the arguments or baseline could not be used, and 2
+/// if the baseline regressed.
+int perfMode(int argc, char *argv[]) {
+
+    std::string baselinePath;
+    std::string outputPath;
+    double tolerance = 0.25;
+
+    for (int i = 0; i < argc; i++) {
+        std::string option = argv[i];
+        if ((i + 1 < argc) && (option == "--baseline")) {
+            baselinePath = argv[++i];
+        } else if ((i + 1 < argc) && (option == "--output")) {
+            outputPath = argv[++i];
+        } else if ((i + 1 < argc) && (option == "--tolerance")) {
+            tolerance = std::atof(argv[++i]);
+        } else {
+            std::cerr << "Usage: 5011_p2 --perf [--baseline file] "
+                         "[--tolerance share] [--output file]" << endl;
+            return 1;
+        }
+    }
+
+    const int scaleFactor = 200;
+
+    PerfGate perfGate;
+    for (int i = 0; i < TEST_COUNT; i++) {
+        std::vector<int> values(TEST_ARRAYS[i], TEST_ARRAYS[i] + TEST_SIZE);
+        perfGate.addScenario("test" + std::to_string(i), values,
+                             COLLISION_RESULTS[i], INVERSION_RESULTS[i], 50, 24);
+    }
+
+    // every copy of a value adds one collision, and every pairing of copies
+    // is an inversion
+    for (int i = 0; i < TEST_COUNT; i++) {
+        std::vector<int> values;
+        for (int copy = 0; copy < scaleFactor; copy++) {
+            values.insert(values.end(), TEST_ARRAYS[i], TEST_ARRAYS[i] + TEST_SIZE);
+        }
+        perfGate.addScenario("test" + std::to_string(i) + "x" + std::to_string(scaleFactor),
+                             values,
+                             TEST_SIZE * (scaleFactor - 1) + COLLISION_RESULTS[i],
+                             INVERSION_RESULTS[i] * scaleFactor * scaleFactor, 5, 24);
+    }
+
+    bool passed = perfGate.run();
+
+    if (outputPath.empty()) {
+        perfGate.writeJson(cout);
+    } else {
+        std::ofstream output(outputPath);
+        perfGate.writeJson(output);
+        if (!output) {
+            std::cerr << "Could not write " << outputPath << endl;
+            return 1;
+        }
+    }
+
+    if (!passed) {
+        std::cerr << "A scenario did not return its asserted results." << endl;
+        return 1;
+    }
+
+    if (!baselinePath.empty()) {
+        int regressions = perfGate.compareBaseline(baselinePath, tolerance, std::cerr);
+        if (regressions < 0) {
+            std::cerr << "Could not read baseline " << baselinePath << endl;
+            return 1;
+        }
+        if (regressions > 0) {
+            std::cerr << regressions << " regressions beyond a tolerance of "
+                      << tolerance << endl;
+            return 2;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+
+    if ((argc > 1) && (std::string(argv[1]) == "--perf")) {
+        return perfMode(argc - 2, argv + 2);
+    }
+
 
     cout << "The following are tests of the DuelingJP class.";
 
@@ -229,6 +810,36 @@ int main() {
     // vector test
     moveVectorTest();
 
+    // membership test
+    membershipTest();
+
+    // deferred jump test
+    deferredJumpTest();
+
+    // trace test
+    traceTest();
+
+    // peek test
+    peekTest();
+
+    // batch test
+    batchTest();
+
+    // join test
+    joinTest();
+
+    // prime index test
+    primeIndexTest();
+
+    // server test
+    serverTest();
+
+    // sharded test
+    shardedTest();
+
+    // bulk reset test
+    bulkResetTest();
+
     return 0;
 
 
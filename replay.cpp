@@ -0,0 +1,156 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "DuelingJP.h"
+#include "OpTrace.h"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/*
+ * replay re-executes a trace written by DuelingJP::dumpTrace against a fresh
+ * DuelingJP object. It prints the time taken by every operation, a summary
+ * per kind of operation, and whether each result matches the recorded one.
+ *
+ * Usage: jp_replay <trace file> [--quiet]
+ * --quiet prints only the summary.
+ *
+ * Exits with 1 if the trace cannot be read or any result differs from the
+ * recorded result.
+ */
+
+const int OPERATION_COUNT = OpTrace::ReviveAll + 1;
+
+/// OperationSummary totals the timings for one kind of operation.
+struct OperationSummary {
+    int count = 0;
+    long long totalNanos = 0;
+    long long maxNanos = 0;
+};
+
+/// runRecord performs a recorded operation on a DuelingJP object.
+/// @param [in] testJP The DuelingJP object to run the operation on.
+/// @param [in] record The recorded operation.
+/// @param [in,out] handleMap Maps the handles of the traced object to the
+/// handles of testJP.
+/// @return The result of the operation.
+long long runRecord(DuelingJP &testJP, const OpTrace::Record &record,
+              std::unordered_map<int, int> &handleMap) {
+
+    switch (record.operation) {
+        case OpTrace::CountCollisionsUp:
+            return testJP.countCollisions(true);
+        case OpTrace::CountCollisionsDown:
+            return testJP.countCollisions(false);
+        case OpTrace::CountInversions:
+            return testJP.countInversions();
+        case OpTrace::AddJumper:
+            // handles are only compared through the operations using them
+            handleMap[(int)record.result] = testJP.addJumper(record.argument);
+            return record.result;
+        case OpTrace::RemoveJumper: {
+            auto handle = handleMap.find(record.argument);
+            return testJP.removeJumper((handle != handleMap.end()) ? handle->second : -1);
+        }
+        case OpTrace::SetDeferredJumps:
+            // the result holds the number settled per query
+            testJP.setDeferredJumps(record.argument != 0, (int)record.result);
+            return record.result;
+        case OpTrace::SettleJumps:
+            return testJP.settleJumps(record.argument);
+        case OpTrace::ResetAll:
+            return testJP.resetAll();
+        case OpTrace::ReviveAll:
+            return testJP.reviveAll();
+        default:
+            return 0;
+    }
+}
+
+int main(int argc, char *argv[]) {
+
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <trace file> [--quiet]" << endl;
+        return 1;
+    }
+    bool quiet = (argc > 2) && (std::string(argv[2]) == "--quiet");
+
+    std::vector<int> initValues;
+    std::vector<OpTrace::HandleEntry> initHandles;
+    std::vector<OpTrace::Record> records;
+    unsigned long long dropped = 0;
+
+    if (!OpTrace::load(argv[1], initValues, initHandles, records, dropped)) {
+        cerr << "Could not read trace " << argv[1] << endl;
+        return 1;
+    }
+
+    cout << "Replaying " << records.size() << " operations on "
+         << initValues.size() << " JumpPrime objects." << endl;
+    if (dropped > 0) {
+        cout << "Warning: the last " << dropped << " operations did not fit "
+             << "in the trace and are not replayed." << endl;
+    }
+
+    std::vector<int> replayHandles(initValues.size());
+    DuelingJP testJP(initValues.data(), (int)initValues.size(), replayHandles.data());
+
+    std::unordered_map<int, int> handleMap;
+    for (const OpTrace::HandleEntry &entry : initHandles) {
+        if ((entry.position >= 0) && (entry.position < (int)replayHandles.size())) {
+            handleMap[entry.handle] = replayHandles[entry.position];
+        }
+    }
+
+    OperationSummary summary[OPERATION_COUNT];
+    int mismatches = 0;
+
+    for (size_t i = 0; i < records.size(); i++) {
+        const OpTrace::Record &record = records[i];
+
+        auto start = std::chrono::steady_clock::now();
+        long long result = runRecord(testJP, record, handleMap);
+        long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+        if (result != record.result) {
+            mismatches++;
+        }
+
+        if (record.operation < OPERATION_COUNT) {
+            OperationSummary &opSummary = summary[record.operation];
+            opSummary.count++;
+            opSummary.totalNanos = opSummary.totalNanos + elapsed;
+            if (elapsed > opSummary.maxNanos) {
+                opSummary.maxNanos = elapsed;
+            }
+        }
+
+        if (!quiet) {
+            cout << i << " " << OpTrace::getOperationName(record.operation)
+                 << " arg=" << record.argument << " result=" << result;
+            if (result != record.result) {
+                cout << " (recorded " << record.result << ")";
+            }
+            cout << " " << elapsed << " ns" << endl;
+        }
+    }
+
+    cout << "Summary" << endl;
+    for (int op = 0; op < OPERATION_COUNT; op++) {
+        if (summary[op].count > 0) {
+            cout << OpTrace::getOperationName(op) << ": " << summary[op].count
+                 << " calls, mean " << summary[op].totalNanos / summary[op].count
+                 << " ns, max " << summary[op].maxNanos << " ns" << endl;
+        }
+    }
+    cout << mismatches << " results differed from the trace." << endl;
+
+    return (mismatches == 0) ? 0 : 1;
+}
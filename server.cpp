@@ -0,0 +1,66 @@
+// Date: 10/19/2026
+// Revision: 1.0
+
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include "DuelServer.h"
+#include "PrimeIndex.h"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+/*
+ * server runs a DuelServer until it receives SIGINT or SIGTERM.
+ *
+ * Usage: jp_server <socket path> [prime index file]
+ * If a prime index file (written by PrimeIndex::save) is given, it is
+ * mapped into memory and used for every nearest prime lookup in its range.
+ */
+
+/// The running server, for the signal handler.
+DuelServer *activeServer = nullptr;
+
+/// stopServer asks the running server to stop.
+/// @param [in] signalNumber The signal received.
+extern "C" void stopServer(int signalNumber) {
+    (void)signalNumber;
+    if (activeServer != nullptr) {
+        activeServer->stop();
+    }
+}
+
+int main(int argc, char *argv[]) {
+
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <socket path> [prime index file]" << endl;
+        return 1;
+    }
+
+    std::unique_ptr<PrimeIndex> primeIndex;
+    if (argc > 2) {
+        primeIndex = PrimeIndex::load(argv[2]);
+        if (primeIndex == nullptr) {
+            cerr << "Could not load prime index " << argv[2] << endl;
+            return 1;
+        }
+        JumpPrime::setPrimeIndex(primeIndex.get());
+    }
+
+    DuelServer server(argv[1]);
+    activeServer = &server;
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+
+    cout << "Serving DuelingJP requests on " << argv[1] << endl;
+    if (!server.serve()) {
+        cerr << "Could not listen on " << argv[1] << endl;
+        return 1;
+    }
+
+    activeServer = nullptr;
+    JumpPrime::setPrimeIndex(nullptr);
+
+    return 0;
+}